@@ -0,0 +1,350 @@
+"""Archetype storage for game object components.
+
+Every GameObject in a scene is an entity of the scene's EntityStore.
+Entities with the same set of component types share an Archetype: one list
+column per component type, with rows aligned to the entities list. Numeric
+attributes declared with EcsField live in NumPy columns of the archetype
+instead of on the component, so a system can process a whole column at
+once, while other attributes are reached through the component columns:
+
+    for chunk in scene.query(CrowdAgentComponent, SpriteComponent):
+        slots = chunk.field(CrowdAgentComponent, "slot")
+        for sprite, facing in zip(chunk.column(SpriteComponent), crowd.facing[slots].tolist()):
+            sprite.rotation = facing
+
+The component itself still reads and writes the attribute as usual, so the
+GameObject API keeps working, but each such access goes through the
+descriptor and costs many times a plain attribute. Declare EcsFields only for
+values that are set rarely and processed in bulk; keep attributes that
+components touch every frame plain. Queries match component types exactly (the
+class passed to add_component), and are cached until a new archetype
+appears.
+"""
+
+from __future__ import annotations
+
+from typing import Any, Dict, FrozenSet, Iterator, List, Optional, Tuple, Type
+
+import numpy as np
+
+
+class EcsField:
+    """Numeric component attribute stored in its archetype's NumPy column.
+
+    While the component is not stored in an archetype (before its object is
+    added to a scene, or inside a MultiComponent), the value is kept in the
+    component's ecs_values dict.
+    """
+    def __init__(self, dtype: Any = np.float64, default: Any = 0.0) -> None:
+        """Configure the column.
+
+        Args:
+            dtype: NumPy dtype of the column.
+            default: Value before the attribute is first set.
+
+        Returns:
+            None
+        """
+        self.dtype = np.dtype(dtype)
+        self.default = default
+        self.name = ""
+
+    def __set_name__(self, owner: type, name: str) -> None:
+        """Register the field in the owner class's ecs_fields.
+
+        Args:
+            owner: Component class declaring the field.
+            name: Attribute name.
+
+        Returns:
+            None
+        """
+        self.name = name
+        if "ecs_fields" not in owner.__dict__:
+            owner.ecs_fields = dict(getattr(owner, "ecs_fields", {}))
+        owner.ecs_fields[name] = self
+
+    def _column(self, component: Any) -> Tuple[Optional[np.ndarray], int]:
+        """Find the column and row holding this field for a component.
+
+        Args:
+            component: Component instance.
+
+        Returns:
+            (column, row), or (None, -1) if the component is not stored.
+        """
+        entity = component.owner
+        archetype = entity.ecs_archetype if entity is not None else None
+        if archetype is None:
+            return None, -1
+        key = type(component)
+        fields = archetype.fields.get(key)
+        row = entity.ecs_row
+        if fields is None or archetype.columns[key][row] is not component:
+            return None, -1
+        return fields[self.name], row
+
+    def __get__(self, component: Any, owner: Optional[type] = None) -> Any:
+        """Read the value from the archetype column, or from ecs_values.
+
+        Args:
+            component: Component instance, or None for class access.
+            owner: Component class.
+
+        Returns:
+            The value, or the field itself for class access.
+        """
+        if component is None:
+            return self
+        column, row = self._column(component)
+        if column is None:
+            return component.__dict__.get("ecs_values", {}).get(self.name, self.default)
+        return column.item(row)
+
+    def __set__(self, component: Any, value: Any) -> None:
+        """Write the value to the archetype column, or to ecs_values.
+
+        Args:
+            component: Component instance.
+            value: New value.
+
+        Returns:
+            None
+        """
+        column, row = self._column(component)
+        if column is None:
+            component.__dict__.setdefault("ecs_values", {})[self.name] = value
+        else:
+            column[row] = value
+
+
+class Archetype:
+    """Storage for all entities with one exact set of component types.
+
+    Attributes:
+        types: Component types of the entities, in a stable order.
+        entities: Entities stored here; row i of every column belongs to entities[i].
+        columns: Component instances per type.
+        fields: NumPy columns per type and EcsField name (capacity rows; use field() for the live rows).
+    """
+    def __init__(self, types: Tuple[type, ...], capacity: int = 16) -> None:
+        """Create empty columns.
+
+        Args:
+            types: Component types.
+            capacity: Initial rows of the NumPy columns.
+
+        Returns:
+            None
+        """
+        self.types = types
+        self.entities: List[Any] = []
+        self.columns: Dict[type, List[Any]] = {cls: [] for cls in types}
+        self.fields: Dict[type, Dict[str, np.ndarray]] = {}
+        for cls in types:
+            declared = getattr(cls, "ecs_fields", None)
+            if declared:
+                self.fields[cls] = {name: np.full(capacity, field.default, dtype=field.dtype)
+                                    for name, field in declared.items()}
+        self.capacity = capacity
+
+    def __len__(self) -> int:
+        """Count the stored entities.
+
+        Returns:
+            Number of rows in use.
+        """
+        return len(self.entities)
+
+    def column(self, cls: Type[Any]) -> List[Any]:
+        """Get the components of one type.
+
+        Args:
+            cls: Component type.
+
+        Returns:
+            Components in row order.
+        """
+        return self.columns[cls]
+
+    def field(self, cls: Type[Any], name: str) -> np.ndarray:
+        """Get the live rows of a numeric field. Writes go straight to the components.
+
+        Args:
+            cls: Component type.
+            name: EcsField name.
+
+        Returns:
+            View of len(self) values.
+        """
+        return self.fields[cls][name][:len(self.entities)]
+
+    def append(self, entity: Any) -> int:
+        """Add an entity, filling its row from its components.
+
+        Args:
+            entity: Object with a components dict holding exactly self.types.
+
+        Returns:
+            Row of the entity.
+        """
+        row = len(self.entities)
+        if row >= self.capacity:
+            self.capacity *= 2
+            for fields in self.fields.values():
+                for name, column in fields.items():
+                    grown = np.zeros(self.capacity, dtype=column.dtype)
+                    grown[:row] = column[:row]
+                    fields[name] = grown
+        self.entities.append(entity)
+        components = entity.components
+        for cls, column in self.columns.items():
+            column.append(components[cls])
+        for cls, fields in self.fields.items():
+            values = components[cls].__dict__.get("ecs_values", {})
+            for name, column in fields.items():
+                column[row] = values.get(name, cls.ecs_fields[name].default)
+        return row
+
+    def remove(self, row: int) -> None:
+        """Remove a row, saving its field values back into the components.
+
+        The last row moves into the gap.
+
+        Args:
+            row: Row to remove.
+
+        Returns:
+            None
+        """
+        for cls, fields in self.fields.items():
+            values = self.columns[cls][row].__dict__.setdefault("ecs_values", {})
+            for name, column in fields.items():
+                values[name] = column.item(row)
+        last = len(self.entities) - 1
+        if row != last:
+            moved = self.entities[last]
+            self.entities[row] = moved
+            moved.ecs_row = row
+            for column in self.columns.values():
+                column[row] = column[last]
+            for fields in self.fields.values():
+                for column in fields.values():
+                    column[row] = column[last]
+        self.entities.pop()
+        for column in self.columns.values():
+            column.pop()
+
+
+class Query:
+    """Cached list of the archetypes that hold a set of component types.
+
+    Iterating yields the non-empty archetypes (chunks).
+    """
+    def __init__(self, store: EntityStore, types: Tuple[type, ...]) -> None:
+        """Create the query. Use Scene.query or EntityStore.query to get a cached one.
+
+        Args:
+            store: Store to search.
+            types: Component types an archetype must contain.
+
+        Returns:
+            None
+        """
+        self.store = store
+        self.types = frozenset(types)
+        self.archetypes: List[Archetype] = []
+        self.version = -1
+
+    def __iter__(self) -> Iterator[Archetype]:
+        """Iterate the non-empty matching archetypes, refreshing the list if the store changed.
+
+        Returns:
+            Iterator over archetypes.
+        """
+        if self.version != self.store.version:
+            self.archetypes = [archetype for key, archetype in self.store.archetypes.items()
+                               if self.types <= key]
+            self.version = self.store.version
+        for archetype in self.archetypes:
+            if archetype.entities:
+                yield archetype
+
+    def entities(self) -> List[Any]:
+        """List every matching entity.
+
+        Returns:
+            Entities of all chunks, chunk by chunk.
+        """
+        return [entity for archetype in self for entity in archetype.entities]
+
+
+class EntityStore:
+    """Archetype tables for the entities of one scene.
+
+    Attributes:
+        archetypes: Archetype per component type set, in creation order.
+        version: Incremented whenever an archetype is created.
+    """
+    def __init__(self) -> None:
+        """Create an empty store.
+
+        Returns:
+            None
+        """
+        self.archetypes: Dict[FrozenSet[type], Archetype] = {}
+        self.queries: Dict[Tuple[type, ...], Query] = {}
+        self.version = 0
+
+    def place(self, entity: Any) -> None:
+        """Store an entity in the archetype matching its current components.
+
+        Call after adding the entity and whenever its component set changes.
+
+        Args:
+            entity: GameObject with components, ecs_archetype, and ecs_row.
+
+        Returns:
+            None
+        """
+        key = frozenset(entity.components)
+        archetype = self.archetypes.get(key)
+        if archetype is None:
+            types = tuple(sorted(key, key=lambda cls: (cls.__module__, cls.__qualname__)))
+            archetype = Archetype(types)
+            self.archetypes[key] = archetype
+            self.version += 1
+        self.remove(entity)
+        entity.ecs_row = archetype.append(entity)
+        entity.ecs_archetype = archetype
+
+    def remove(self, entity: Any) -> None:
+        """Take an entity out of its archetype. Field values go back onto its components.
+
+        Args:
+            entity: Stored entity.
+
+        Returns:
+            None
+        """
+        archetype = entity.ecs_archetype
+        if archetype is None:
+            return
+        archetype.remove(entity.ecs_row)
+        entity.ecs_archetype = None
+        entity.ecs_row = -1
+
+    def query(self, *types: type) -> Query:
+        """Get the cached query for a set of component types.
+
+        Args:
+            *types: Component types every matching entity has.
+
+        Returns:
+            Query whose iteration yields matching archetypes.
+        """
+        query = self.queries.get(types)
+        if query is None:
+            query = Query(self, types)
+            self.queries[types] = query
+        return query
@@ -3,16 +3,98 @@ from __future__ import annotations
 from typing import Any, Dict, List, Optional, Tuple, Type, TypeVar
 import pyray as rl
 
+from engine import render
+from engine.ecs import Archetype, EntityStore, Query
+
 T = TypeVar("T")
 
 
-class Component:
+class Ticking:
+    """Reduced-rate update schedule shared by GameObject and Component.
+
+    An update runs every tick_interval * tick_lod frames and receives the
+    delta time accumulated since the last run. The first run is staggered by
+    a phase the scene hands out round-robin per period, so 1/N of a group
+    with the same period updates each frame. tick_lod is a multiplier set by
+    TickLodService from the distance to the nearest viewer.
+
+    Attributes:
+        tick_interval: Frames between updates (1 = every frame).
+        tick_lod: Level-of-detail multiplier on tick_interval.
+        tick_period: tick_interval * tick_lod.
+        tick_countdown: Frames until the next update (0 = phase not assigned yet).
+        tick_delta: Delta time accumulated since the last update.
+    """
+    def __init__(self) -> None:
+        """Start at full rate with no phase assigned.
+
+        Returns:
+            None
+        """
+        self.tick_interval: int = 1
+        self.tick_lod: int = 1
+        self.tick_period: int = 1
+        self.tick_countdown: int = 0
+        self.tick_delta: float = 0.0
+
+    def set_tick_interval(self, interval: int) -> None:
+        """Update every interval frames. The phase is assigned on the next frame.
+
+        Args:
+            interval: Frames between updates.
+
+        Returns:
+            None
+        """
+        self.tick_interval = max(1, int(interval))
+        self.tick_period = self.tick_interval * self.tick_lod
+        self.tick_countdown = 0
+
+    def set_tick_lod(self, lod: int) -> None:
+        """Set the level-of-detail multiplier, keeping the current phase where possible.
+
+        Args:
+            lod: Multiplier on tick_interval (1 = full rate).
+
+        Returns:
+            None
+        """
+        self.tick_lod = max(1, int(lod))
+        self.tick_period = self.tick_interval * self.tick_lod
+        if self.tick_countdown > self.tick_period:
+            self.tick_countdown = self.tick_period
+
+    def tick(self, delta_time: float, scene: Scene) -> float:
+        """Advance the schedule by one frame.
+
+        Args:
+            delta_time: Seconds since the last frame.
+            scene: Scene that hands out phases.
+
+        Returns:
+            The accumulated delta time if the update is due this frame, otherwise -1.
+        """
+        self.tick_delta += delta_time
+        countdown = self.tick_countdown - 1
+        if countdown < 0:
+            countdown = scene.next_tick_phase(self.tick_period)
+        if countdown > 0:
+            self.tick_countdown = countdown
+            return -1.0
+        self.tick_countdown = self.tick_period
+        accumulated = self.tick_delta
+        self.tick_delta = 0.0
+        return accumulated
+
+
+class Component(Ticking):
     """Base class for all game object components.
 
     Attributes:
         owner: The GameObject that owns this component, or None if unassigned.
     """
     def __init__(self) -> None:
+        super().__init__()
         self.owner: Optional[GameObject] = None
 
     def init(self) -> None:
@@ -23,6 +105,14 @@ class Component:
         """
         pass
 
+    def unload(self) -> None:
+        """Lifecycle hook called when the owning object is unloaded with its scene.
+
+        Returns:
+            None
+        """
+        pass
+
     def update(self, delta_time: float) -> None:
         """Lifecycle hook called every frame to update the component.
 
@@ -43,20 +133,34 @@ class Component:
         pass
 
 
-class GameObject:
+class GameObject(Ticking):
     """Base class for all game objects (entities) in a scene.
 
+    A reduced tick rate (set_tick_interval, set_tick_lod) applies to the
+    object's update and all of its components; components can also have
+    their own. Drawing always happens every frame.
+
+    Once added to a scene, the object is an entity of the scene's
+    EntityStore: its components live in the columns of the archetype for
+    its component set (see engine/ecs.py), and components is its index
+    into them.
+
     Attributes:
         scene: The Scene this object belongs to.
         components: Mapping of component type to component instance.
         tags: Set of string tags for lookup/filtering.
         is_active: If False, update/draw are skipped.
+        ecs_archetype: Archetype storing the object, or None outside a scene.
+        ecs_row: Row of the object in ecs_archetype.
     """
     def __init__(self) -> None:
+        super().__init__()
         self.scene: Optional[Scene] = None
         self.components: Dict[Type[Any], Component] = {}
         self.tags: set[str] = set()
         self.is_active: bool = True
+        self.ecs_archetype: Optional[Archetype] = None
+        self.ecs_row: int = -1
 
     def init(self) -> None:
         """Lifecycle hook called when the object is initialized.
@@ -66,6 +170,14 @@ class GameObject:
         """
         pass
 
+    def unload(self) -> None:
+        """Lifecycle hook called when the object is unloaded with its scene, after its components.
+
+        Returns:
+            None
+        """
+        pass
+
     def update(self, delta_time: float) -> None:
         """Lifecycle hook called every frame to update the object.
 
@@ -95,6 +207,16 @@ class GameObject:
         for component in list(self.components.values()):
             component.init()
 
+    def unload_object(self) -> None:
+        """Unload the components, then the object.
+
+        Returns:
+            None
+        """
+        for component in list(self.components.values()):
+            component.unload()
+        self.unload()
+
     def update_object(self, delta_time: float) -> None:
         """Update the object and its components if active.
 
@@ -106,9 +228,18 @@ class GameObject:
         """
         if not self.is_active:
             return
+        if self.tick_period > 1 or self.tick_delta:
+            delta_time = self.tick(delta_time, self.scene)
+            if delta_time < 0.0:
+                return
         self.update(delta_time)
         for component in list(self.components.values()):
-            component.update(delta_time)
+            if component.tick_period > 1 or component.tick_delta:
+                component_delta = component.tick(delta_time, self.scene)
+                if component_delta >= 0.0:
+                    component.update(component_delta)
+            else:
+                component.update(delta_time)
 
     def draw_object(self) -> None:
         """Draw the object and its components if active.
@@ -118,8 +249,11 @@ class GameObject:
         """
         if not self.is_active:
             return
+        stats = render.stats
+        stats.owner = type(self)
         self.draw()
         for component in list(self.components.values()):
+            stats.owner = type(component)
             component.draw()
 
     def add_component(self, component_or_cls: Any, *args: Any, **kwargs: Any) -> Component:
@@ -142,6 +276,8 @@ class GameObject:
         if key in self.components:
             print(f"Duplicate component added: {key.__name__}")
         self.components[key] = component
+        if self.ecs_archetype is not None:
+            self.scene.entities.place(self)
         return component
 
     def get_component(self, cls: Type[T]) -> Optional[T]:
@@ -211,6 +347,14 @@ class Service:
         """
         pass
 
+    def unload(self) -> None:
+        """Lifecycle hook called when the scene is unloaded; release what init created.
+
+        Returns:
+            None
+        """
+        pass
+
     def update(self, delta_time: float) -> None:
         """Lifecycle hook called every frame to update the service.
 
@@ -241,6 +385,17 @@ class Service:
         self.init()
         self.is_init = True
 
+    def unload_service(self) -> None:
+        """Unload the service if it was initialized.
+
+        Returns:
+            None
+        """
+        if not self.is_init:
+            return
+        self.unload()
+        self.is_init = False
+
     def draw_service(self) -> None:
         """Draw the service if visible.
 
@@ -256,9 +411,11 @@ class Manager:
 
     Attributes:
         is_init: True once init_manager has been run.
+        game: Owning Game instance.
     """
     def __init__(self) -> None:
         self.is_init: bool = False
+        self.game: Optional[Game] = None
 
     def init(self) -> None:
         """Lifecycle hook called when the manager is initialized.
@@ -268,6 +425,71 @@ class Manager:
         """
         pass
 
+    def begin_frame(self) -> None:
+        """Lifecycle hook called at the start of every frame, before the scene updates.
+
+        Returns:
+            None
+        """
+        pass
+
+    def update(self, delta_time: float) -> None:
+        """Lifecycle hook called every frame after the scene updates, before drawing.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        pass
+
+    def draw(self) -> None:
+        """Lifecycle hook called every drawn frame after the scene draws, before rl.end_drawing.
+
+        Returns:
+            None
+        """
+        pass
+
+    def end_frame(self) -> None:
+        """Lifecycle hook called at the end of every frame, after rl.end_drawing.
+
+        Returns:
+            None
+        """
+        pass
+
+    def on_scene_init(self, scene: Scene) -> None:
+        """Lifecycle hook called right after a scene has been initialized.
+
+        Args:
+            scene: The scene that was initialized.
+
+        Returns:
+            None
+        """
+        pass
+
+    def on_scene_exit(self, scene: Scene) -> None:
+        """Lifecycle hook called right after the current scene's on_exit (transition or removal).
+
+        Args:
+            scene: The scene that was exited.
+
+        Returns:
+            None
+        """
+        pass
+
+    def shutdown(self) -> None:
+        """Lifecycle hook called from Game.shutdown, after every scene has been unloaded.
+
+        Returns:
+            None
+        """
+        pass
+
     def init_manager(self) -> None:
         """Initialize the manager once.
 
@@ -288,12 +510,15 @@ class Scene:
         services: List of (type, Service) pairs.
         game: Owning Game instance.
         is_init: True once init_scene has been run.
+        entities: Archetype storage for the objects' components.
     """
     def __init__(self) -> None:
         self.game_objects: List[GameObject] = []
         self.services: List[Tuple[Type[Any], Service]] = []
         self.game: Optional[Game] = None
         self.is_init: bool = False
+        self.tick_phases: Dict[int, int] = {}
+        self.entities = EntityStore()
 
     def init_services(self) -> None:
         """Hook to add services before scene init.
@@ -311,6 +536,14 @@ class Scene:
         """
         pass
 
+    def unload(self) -> None:
+        """Lifecycle hook called when the scene is unloaded, after its objects and before its services.
+
+        Returns:
+            None
+        """
+        pass
+
     def update(self, delta_time: float) -> None:
         """Lifecycle hook called every frame to update the scene.
 
@@ -346,6 +579,23 @@ class Scene:
             game_object.init_object()
         self.is_init = True
 
+    def unload_scene(self) -> None:
+        """Unload objects, the scene, then services in reverse order of addition.
+
+        An unloaded scene is not initialized again; Game.remove_scene drops it.
+
+        Returns:
+            None
+        """
+        if not self.is_init:
+            return
+        for game_object in reversed(self.game_objects):
+            game_object.unload_object()
+        self.unload()
+        for _, service in reversed(self.services):
+            service.unload_service()
+        self.is_init = False
+
     def update_scene(self, delta_time: float) -> None:
         """Update the scene, services, and objects.
 
@@ -367,11 +617,40 @@ class Scene:
         Returns:
             None
         """
+        stats = render.stats
+        stats.owner = type(self)
         self.draw()
         for _, service in self.services:
+            stats.owner = type(service)
             service.draw_service()
         for game_object in list(self.game_objects):
             game_object.draw_object()
+        # Whatever an overriding draw_scene draws after this belongs to the scene.
+        stats.owner = type(self)
+
+    def query(self, *types: Type[Any]) -> Query:
+        """Get a cached query over the objects that have all of the given component types.
+
+        Args:
+            *types: Component classes, as passed to add_component.
+
+        Returns:
+            Query; iterating it yields archetype chunks with column() and field() views.
+        """
+        return self.entities.query(*types)
+
+    def next_tick_phase(self, period: int) -> int:
+        """Hand out phases round-robin for a tick period, so updates spread evenly over frames.
+
+        Args:
+            period: Frames between updates.
+
+        Returns:
+            Frames until the first update (0..period-1).
+        """
+        phase = self.tick_phases.get(period, 0)
+        self.tick_phases[period] = (phase + 1) % period
+        return phase
 
     def on_enter(self) -> None:
         """Hook called when the scene becomes active.
@@ -400,6 +679,7 @@ class Scene:
         """
         game_object.scene = self
         self.game_objects.append(game_object)
+        self.entities.place(game_object)
         return game_object
 
     def add_game_object_type(self, cls: Type[T], *args: Any, **kwargs: Any) -> T:
@@ -461,6 +741,20 @@ class Scene:
         print(f"Service of requested type not found in scene: {cls.__name__}")
         raise RuntimeError(f"Service not found: {cls.__name__}")
 
+    def has_service(self, cls: Type[Any]) -> bool:
+        """Check if a service of a given type has been added.
+
+        Args:
+            cls: Service class to look up.
+
+        Returns:
+            True if the service exists, otherwise False.
+        """
+        for svc_key, _ in self.services:
+            if svc_key == cls:
+                return True
+        return False
+
     def get_game_objects_with_tag(self, tag: str) -> List[GameObject]:
         """Get all objects that contain a tag.
 
@@ -482,6 +776,12 @@ class Game:
         scene_order: Ordered list of scene names.
         current_scene: Active scene.
         next_scene: Scene queued for transition.
+        draw_enabled: If False, scenes are updated but not drawn (e.g. fast replays).
+        fixed_delta_time: If > 0, every frame is simulated with this step instead of
+            the delta time passed to update (deterministic mode).
+        seed: Seed for scene random number generators (RandomService).
+        headless: If True, no window, GPU, or audio resources are created and nothing
+            is drawn, so scenes can be simulated in batch (tools/batch_runner.py).
     """
     def __init__(self) -> None:
         self.managers: Dict[Type[Any], Manager] = {}
@@ -489,6 +789,10 @@ class Game:
         self.scene_order: List[str] = []
         self.current_scene: Optional[Scene] = None
         self.next_scene: Optional[Scene] = None
+        self.draw_enabled: bool = True
+        self.fixed_delta_time: float = 0.0
+        self.seed: int = 0
+        self.headless: bool = False
 
     def init(self) -> None:
         """Initialize all managers.
@@ -503,27 +807,74 @@ class Game:
         """Update the active scene and render it.
 
         Args:
-            delta_time: Seconds since the last frame.
+            delta_time: Seconds since the last frame (ignored if fixed_delta_time is set).
 
         Returns:
             None
         """
+        if self.fixed_delta_time > 0.0:
+            delta_time = self.fixed_delta_time
+        for manager in self.managers.values():
+            manager.begin_frame()
+
         if self.current_scene:
-            self.current_scene.init_scene()
+            if not self.current_scene.is_init:
+                self.current_scene.init_scene()
+                for manager in self.managers.values():
+                    manager.on_scene_init(self.current_scene)
             self.current_scene.update_scene(delta_time)
+            for manager in self.managers.values():
+                manager.update(delta_time)
+
+            if not self.headless:
+                if self.draw_enabled:
+                    render.begin_drawing()
+                    rl.clear_background(rl.RAYWHITE)
+                    render.stats.owner = type(self.current_scene)
+                    self.current_scene.draw_scene()
+                    for manager in self.managers.values():
+                        render.stats.owner = type(manager)
+                        manager.draw()
+                    render.end_drawing()
+                else:
+                    # end_drawing normally polls window events.
+                    rl.poll_input_events()
 
-            rl.begin_drawing()
-            rl.clear_background(rl.RAYWHITE)
-            self.current_scene.draw_scene()
-            rl.end_drawing()
+        for manager in self.managers.values():
+            manager.end_frame()
 
         if self.next_scene:
             if self.current_scene:
-                self.current_scene.on_exit()
+                self.exit_scene(self.current_scene)
             self.current_scene = self.next_scene
             self.current_scene.on_enter()
             self.next_scene = None
 
+    def exit_scene(self, scene: Scene) -> None:
+        """Run a scene's on_exit and the managers' on_scene_exit.
+
+        Args:
+            scene: The scene being left.
+
+        Returns:
+            None
+        """
+        scene.on_exit()
+        for manager in self.managers.values():
+            manager.on_scene_exit(scene)
+
+    def shutdown(self) -> None:
+        """Remove and unload every scene, then shut the managers down.
+
+        Returns:
+            None
+        """
+        for name in list(self.scene_order):
+            self.remove_scene(name)
+        for manager in self.managers.values():
+            if manager.is_init:
+                manager.shutdown()
+
     def add_manager(self, manager_or_cls: Any, *args: Any, **kwargs: Any) -> Manager:
         """Add a manager instance or construct one from a class.
 
@@ -542,6 +893,7 @@ class Game:
         key = manager.__class__
         if key in self.managers:
             print(f"Duplicate manager added: {key.__name__}")
+        manager.game = self
         self.managers[key] = manager
         return manager
 
@@ -565,6 +917,17 @@ class Game:
             print(f"Manager not initialized: {cls.__name__}")
         return manager  # type: ignore[return-value]
 
+    def has_manager(self, cls: Type[Any]) -> bool:
+        """Check if a manager of a given type has been added.
+
+        Args:
+            cls: Manager class to look up.
+
+        Returns:
+            True if the manager exists, otherwise False.
+        """
+        return cls in self.managers
+
     def add_scene(self, name: str, scene_or_cls: Any, *args: Any, **kwargs: Any) -> Scene:
         """Add a scene instance or construct one from a class.
 
@@ -588,6 +951,27 @@ class Game:
             self.current_scene = scene
         return scene
 
+    def remove_scene(self, name: str) -> None:
+        """Exit a scene if it is current, unload it, and forget it.
+
+        Args:
+            name: Registered name of the scene.
+
+        Returns:
+            None
+        """
+        scene = self.scenes.pop(name, None)
+        if not scene:
+            print(f"Scene not found: {name}")
+            return
+        self.scene_order.remove(name)
+        if scene is self.current_scene:
+            self.exit_scene(scene)
+            self.current_scene = None
+        if scene is self.next_scene:
+            self.next_scene = None
+        scene.unload_scene()
+
     def go_to_scene(self, name: str) -> Optional[Scene]:
         """Queue a transition to a named scene.
 
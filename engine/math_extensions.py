@@ -47,3 +47,163 @@ def vec_normalize(a: rl.Vector2) -> rl.Vector2:
 def vec_from_iter(values: Iterable[float]) -> rl.Vector2:
     x, y = values
     return rl.Vector2(float(x), float(y))
+
+
+def get_view_bounds() -> tuple[float, float, float, float]:
+    """World-space bounds of what the current render target shows.
+
+    The framebuffer's rectangle is mapped back through the current modelview
+    matrix, so inside begin_mode_2d this is the camera's visible area.
+
+    Returns:
+        (min_x, min_y, max_x, max_y).
+    """
+    inverse = rl.matrix_invert(rl.rl_get_matrix_modelview())
+    width = float(rl.rl_get_framebuffer_width())
+    height = float(rl.rl_get_framebuffer_height())
+    corners = [rl.vector2_transform(rl.Vector2(x, y), inverse)
+               for x, y in ((0.0, 0.0), (width, 0.0), (0.0, height), (width, height))]
+    return (min(corner.x for corner in corners), min(corner.y for corner in corners),
+            max(corner.x for corner in corners), max(corner.y for corner in corners))
+
+
+class Vec2:
+    """Mutable 2D vector of Python floats.
+
+    Much cheaper to create and to read or write than the cffi rl.Vector2, so
+    use it for math in hot paths and convert with to_rl() only when calling
+    into raylib. Anything taking an object with x and y (the vec_* helpers,
+    BodyComponent.set_position/set_velocity) accepts a Vec2 directly.
+
+    Operators return new vectors; the *_ip methods modify the vector in place
+    and return it for chaining.
+    """
+    __slots__ = ("x", "y")
+
+    def __init__(self, x: float = 0.0, y: float = 0.0) -> None:
+        self.x = x
+        self.y = y
+
+    @classmethod
+    def from_rl(cls, v) -> "Vec2":
+        return cls(v.x, v.y)
+
+    def to_rl(self) -> rl.Vector2:
+        return rl.Vector2(self.x, self.y)
+
+    def copy(self) -> "Vec2":
+        return Vec2(self.x, self.y)
+
+    def set(self, x: float, y: float) -> "Vec2":
+        self.x = x
+        self.y = y
+        return self
+
+    def set_from(self, v) -> "Vec2":
+        self.x = v.x
+        self.y = v.y
+        return self
+
+    def __iter__(self):
+        yield self.x
+        yield self.y
+
+    def __repr__(self) -> str:
+        return f"Vec2({self.x}, {self.y})"
+
+    def __eq__(self, other) -> bool:
+        return self.x == other.x and self.y == other.y
+
+    def __add__(self, other) -> "Vec2":
+        return Vec2(self.x + other.x, self.y + other.y)
+
+    def __sub__(self, other) -> "Vec2":
+        return Vec2(self.x - other.x, self.y - other.y)
+
+    def __mul__(self, scalar: float) -> "Vec2":
+        return Vec2(self.x * scalar, self.y * scalar)
+
+    __rmul__ = __mul__
+
+    def __truediv__(self, scalar: float) -> "Vec2":
+        return Vec2(self.x / scalar, self.y / scalar)
+
+    def __neg__(self) -> "Vec2":
+        return Vec2(-self.x, -self.y)
+
+    def __iadd__(self, other) -> "Vec2":
+        self.x += other.x
+        self.y += other.y
+        return self
+
+    def __isub__(self, other) -> "Vec2":
+        self.x -= other.x
+        self.y -= other.y
+        return self
+
+    def __imul__(self, scalar: float) -> "Vec2":
+        self.x *= scalar
+        self.y *= scalar
+        return self
+
+    def __itruediv__(self, scalar: float) -> "Vec2":
+        self.x /= scalar
+        self.y /= scalar
+        return self
+
+    def add_scaled_ip(self, other, scalar: float) -> "Vec2":
+        self.x += other.x * scalar
+        self.y += other.y * scalar
+        return self
+
+    def length(self) -> float:
+        return math.sqrt(self.x * self.x + self.y * self.y)
+
+    def length_sq(self) -> float:
+        return self.x * self.x + self.y * self.y
+
+    def dot(self, other) -> float:
+        return self.x * other.x + self.y * other.y
+
+    def normalize_ip(self) -> "Vec2":
+        length = math.sqrt(self.x * self.x + self.y * self.y)
+        if length <= 1e-8:
+            self.x = 0.0
+            self.y = 0.0
+        else:
+            self.x /= length
+            self.y /= length
+        return self
+
+    def clamp_length_ip(self, max_length: float) -> "Vec2":
+        length_sq = self.x * self.x + self.y * self.y
+        if length_sq > max_length * max_length:
+            scale = max_length / math.sqrt(length_sq)
+            self.x *= scale
+            self.y *= scale
+        return self
+
+    def move_towards_ip(self, x: float, y: float, max_delta: float) -> "Vec2":
+        dx = x - self.x
+        dy = y - self.y
+        length = math.sqrt(dx * dx + dy * dy)
+        if length <= max_delta or length < 1e-5:
+            self.x = x
+            self.y = y
+        else:
+            scale = max_delta / length
+            self.x += dx * scale
+            self.y += dy * scale
+        return self
+
+    def shrink_ip(self, amount: float) -> "Vec2":
+        """Reduce the length by amount, stopping at zero."""
+        length = math.sqrt(self.x * self.x + self.y * self.y)
+        if length < 1e-5 or length <= amount:
+            self.x = 0.0
+            self.y = 0.0
+        else:
+            scale = (length - amount) / length
+            self.x *= scale
+            self.y *= scale
+        return self
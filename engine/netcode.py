@@ -0,0 +1,476 @@
+from __future__ import annotations
+
+import heapq
+import random
+import socket
+import struct
+import time
+from typing import Callable, Dict, List, Optional, Tuple
+
+from engine.replay import quantize
+
+# Input packet: header, then count frames of one int8 per action, starting at start_frame.
+#   header: magic, sender player, last frame received contiguously from the peer, start frame, count,
+#           frame of the sender's latest state checksum (-1 if none), checksum
+_MAGIC = b"GJKN"
+_HEADER = struct.Struct("<4sBiiBiI")
+_SCALE = 127.0
+_MAX_PACKET_FRAMES = 32
+_MAX_DATAGRAM = 2048
+
+
+class UdpTransport:
+    """Non-blocking UDP socket talking to a single peer."""
+    def __init__(self, local_port: int, remote_host: str, remote_port: int) -> None:
+        """Bind the local port.
+
+        Args:
+            local_port: Port to receive on.
+            remote_host: Peer host name or address.
+            remote_port: Peer port.
+
+        Returns:
+            None
+        """
+        self.remote = (remote_host, remote_port)
+        self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.socket.bind(("0.0.0.0", local_port))
+        self.socket.setblocking(False)
+
+    def send(self, data: bytes) -> None:
+        """Send a datagram to the peer. Send errors are treated as packet loss.
+
+        Args:
+            data: Datagram payload.
+
+        Returns:
+            None
+        """
+        try:
+            self.socket.sendto(data, self.remote)
+        except OSError:
+            pass
+
+    def receive(self) -> List[bytes]:
+        """Read every datagram waiting on the socket.
+
+        Returns:
+            Payloads in arrival order.
+        """
+        packets = []
+        while True:
+            try:
+                data, _ = self.socket.recvfrom(_MAX_DATAGRAM)
+            except (BlockingIOError, ConnectionResetError):
+                return packets
+            except OSError:
+                return packets
+            packets.append(data)
+
+    def close(self) -> None:
+        """Close the socket.
+
+        Returns:
+            None
+        """
+        self.socket.close()
+
+
+class LossyTransport:
+    """Wrap a transport to add latency, jitter, and packet loss on outgoing datagrams.
+
+    Stands in for a real network when both peers run on one machine.
+    """
+    def __init__(self, transport: UdpTransport, latency_ms: float = 50.0, jitter_ms: float = 10.0,
+                 loss: float = 0.05, seed: int = 0) -> None:
+        """Wrap a transport.
+
+        Args:
+            transport: Transport that actually sends.
+            latency_ms: One-way delay added to every datagram.
+            jitter_ms: Random extra delay, up to this many milliseconds.
+            loss: Fraction of datagrams dropped (0..1).
+            seed: Seed for the loss and jitter generator.
+
+        Returns:
+            None
+        """
+        self.transport = transport
+        self.latency = latency_ms / 1000.0
+        self.jitter = jitter_ms / 1000.0
+        self.loss = loss
+        self.random = random.Random(seed)
+        self.queue: List[Tuple[float, int, bytes]] = []
+        self.sequence = 0
+
+    def send(self, data: bytes) -> None:
+        """Queue a datagram, or drop it.
+
+        Args:
+            data: Datagram payload.
+
+        Returns:
+            None
+        """
+        if self.random.random() >= self.loss:
+            deliver_at = time.perf_counter() + self.latency + self.random.random() * self.jitter
+            heapq.heappush(self.queue, (deliver_at, self.sequence, data))
+            self.sequence += 1
+        self.flush()
+
+    def flush(self) -> None:
+        """Send every queued datagram whose delay has passed.
+
+        Returns:
+            None
+        """
+        now = time.perf_counter()
+        while self.queue and self.queue[0][0] <= now:
+            self.transport.send(heapq.heappop(self.queue)[2])
+
+    def receive(self) -> List[bytes]:
+        """Flush due datagrams and read incoming ones.
+
+        Returns:
+            Payloads in arrival order.
+        """
+        self.flush()
+        return self.transport.receive()
+
+    def close(self) -> None:
+        """Close the wrapped transport.
+
+        Returns:
+            None
+        """
+        self.transport.close()
+
+
+class RollbackSession:
+    """Rollback session between two peers, with input delay and prediction.
+
+    Every frame the local player's input is scheduled input_delay frames ahead
+    and sent to the peer, along with the previous unacknowledged frames so a
+    lost packet is covered by the next one. Frames are simulated straight away
+    with remote input predicted as "same as their last known input". When a
+    remote input arrives that differs from the prediction, the session loads
+    the snapshot taken before that frame and resimulates up to the present.
+
+    The game provides three callbacks through attach: save_state(frame),
+    load_state(frame), and simulate(inputs), which must advance the game by
+    exactly one fixed step using only the given inputs. The session never keeps
+    more than max_rollback frames of unconfirmed remote input; if the peer falls
+    further behind, advance stalls until it catches up.
+
+    With the optional checksum(frame) callback, every checksum_interval frames
+    the state before that frame is checksummed once it can no longer be rolled
+    back (every earlier frame ran with confirmed input), and the peers compare
+    checksums in their packets. A mismatch means the simulations diverged, for
+    example through state a snapshot does not restore.
+
+    Attributes:
+        frame: Next frame to simulate.
+        is_resimulating: True while replaying frames after a rollback.
+        rollbacks: Number of rollbacks performed.
+        resimulated_frames: Total frames simulated again after rollbacks.
+        max_resimulation_ms: Longest time spent in a single rollback.
+        stalled_frames: Frames skipped waiting for the peer.
+        checksums_compared: Frames whose checksum matched the peer's.
+        desync_frame: First frame whose checksum differed from the peer's, or None.
+    """
+    def __init__(self, transport: UdpTransport, local_player: int, player_count: int, action_count: int,
+                 input_delay: int = 2, max_rollback: int = 8, checksum_interval: int = 30) -> None:
+        """Create a session.
+
+        Args:
+            transport: UdpTransport or LossyTransport connected to the peer.
+            local_player: Index of the player controlled on this machine.
+            player_count: Number of players in the session.
+            action_count: Actions per player.
+            input_delay: Frames between reading local input and simulating it.
+            max_rollback: Most frames the session may simulate ahead of confirmed input.
+            checksum_interval: Frames between state checksums compared with the peer.
+
+        Returns:
+            None
+        """
+        self.transport = transport
+        self.local_player = local_player
+        self.player_count = player_count
+        self.action_count = action_count
+        self.input_delay = input_delay
+        self.max_rollback = max_rollback
+        self.frame_struct = struct.Struct(f"<{action_count}b")
+        self.frame = 0
+        self.inputs: List[Dict[int, List[float]]] = [{} for _ in range(player_count)]
+        self.confirmed = [input_delay - 1] * player_count
+        self.remote_acked = input_delay - 1
+        self.predicted: Dict[int, List[List[float]]] = {}
+        self.rollback_frame: Optional[int] = None
+        self.save_state: Optional[Callable[[int], None]] = None
+        self.load_state: Optional[Callable[[int], None]] = None
+        self.simulate: Optional[Callable[[List[List[float]]], None]] = None
+        self.checksum: Optional[Callable[[int], int]] = None
+        self.checksum_interval = checksum_interval
+        self.local_checksums: Dict[int, int] = {}
+        self.remote_checksums: Dict[int, int] = {}
+        self.checksums_compared = 0
+        self.desync_frame: Optional[int] = None
+        self.is_resimulating = False
+        self.rollbacks = 0
+        self.resimulated_frames = 0
+        self.max_resimulation_ms = 0.0
+        self.stalled_frames = 0
+        # Frames before the first local input (and frame -1, the prediction
+        # source before any input arrives) are neutral for every player.
+        neutral = [0.0] * action_count
+        for player_inputs in self.inputs:
+            for frame in range(-1, input_delay):
+                player_inputs[frame] = neutral
+
+    def attach(self, save_state: Callable[[int], None], load_state: Callable[[int], None],
+               simulate: Callable[[List[List[float]]], None],
+               checksum: Optional[Callable[[int], int]] = None) -> None:
+        """Connect the session to the game it drives.
+
+        Args:
+            save_state: Store the current state as the state before a frame.
+            load_state: Restore the state stored for a frame.
+            simulate: Advance the game one fixed step with inputs per player.
+            checksum: Checksum of the state stored for a frame, or None to skip desync detection.
+
+        Returns:
+            None
+        """
+        self.save_state = save_state
+        self.load_state = load_state
+        self.simulate = simulate
+        self.checksum = checksum
+
+    def snapshot_count(self) -> int:
+        """Number of frame snapshots save_state needs to keep (used as a ring).
+
+        Returns:
+            Ring size.
+        """
+        return self.max_rollback + 2
+
+    def _frame_inputs(self, frame: int) -> List[List[float]]:
+        """Get inputs for a frame, predicting any that have not arrived.
+
+        Args:
+            frame: Frame number.
+
+        Returns:
+            Action values per player.
+        """
+        frame_inputs = []
+        for player, player_inputs in enumerate(self.inputs):
+            values = player_inputs.get(frame)
+            if values is None:
+                values = player_inputs[min(frame, self.confirmed[player])]
+            frame_inputs.append(values)
+        return frame_inputs
+
+    def get_inputs(self, frame: int) -> List[List[float]]:
+        """Get the inputs a frame was last simulated with.
+
+        load_state uses this for the frame before the one being loaded, to
+        restore held-button state so pressed/released edges come out the same.
+
+        Args:
+            frame: Frame number.
+
+        Returns:
+            Action values per player.
+        """
+        frame_inputs = self.predicted.get(frame)
+        return frame_inputs if frame_inputs is not None else self._frame_inputs(frame)
+
+    def _send(self) -> None:
+        """Send local input not yet acknowledged by the peer.
+
+        A packet is sent even when everything has been acknowledged, so the
+        peer keeps receiving acknowledgements of its own input.
+
+        Returns:
+            None
+        """
+        newest = self.confirmed[self.local_player]
+        start = max(self.remote_acked + 1, newest - _MAX_PACKET_FRAMES + 1)
+        count = max(0, newest - start + 1)
+        remote_confirmed = min(confirmed for player, confirmed in enumerate(self.confirmed)
+                               if player != self.local_player)
+        local_inputs = self.inputs[self.local_player]
+        checksum_frame = max(self.local_checksums, default=-1)
+        payload = [_HEADER.pack(_MAGIC, self.local_player, remote_confirmed, start, count,
+                                checksum_frame, self.local_checksums.get(checksum_frame, 0))]
+        for frame in range(start, newest + 1):
+            payload.append(self.frame_struct.pack(*[int(round(value * _SCALE)) for value in local_inputs[frame]]))
+        self.transport.send(b"".join(payload))
+
+    def _receive(self) -> None:
+        """Store remote input from incoming packets and note mispredictions.
+
+        Returns:
+            None
+        """
+        for data in self.transport.receive():
+            if len(data) < _HEADER.size:
+                continue
+            magic, player, acked, start, count, checksum_frame, checksum = _HEADER.unpack_from(data, 0)
+            if magic != _MAGIC or player >= self.player_count or player == self.local_player:
+                continue
+            if len(data) < _HEADER.size + count * self.frame_struct.size:
+                continue
+            self.remote_acked = max(self.remote_acked, acked)
+            if checksum_frame >= 0 and checksum_frame not in self.remote_checksums:
+                self.remote_checksums[checksum_frame] = checksum
+                self._compare_checksums(checksum_frame)
+            player_inputs = self.inputs[player]
+            offset = _HEADER.size
+            for frame in range(start, start + count):
+                packed = self.frame_struct.unpack_from(data, offset)
+                offset += self.frame_struct.size
+                if frame <= self.confirmed[player] or frame in player_inputs:
+                    continue
+                values = [value / _SCALE for value in packed]
+                player_inputs[frame] = values
+                predicted = self.predicted.get(frame)
+                if predicted is not None and predicted[player] != values:
+                    if self.rollback_frame is None or frame < self.rollback_frame:
+                        self.rollback_frame = frame
+            while self.confirmed[player] + 1 in player_inputs:
+                self.confirmed[player] += 1
+
+    def _rollback(self) -> None:
+        """Load the snapshot before the first mispredicted frame and resimulate to the present.
+
+        Returns:
+            None
+        """
+        first = self.rollback_frame
+        self.rollback_frame = None
+        if first is None or first >= self.frame:
+            return
+        start = time.perf_counter()
+        self.is_resimulating = True
+        self.load_state(first)
+        for frame in range(first, self.frame):
+            if frame != first:
+                self.save_state(frame)
+            frame_inputs = self._frame_inputs(frame)
+            self.predicted[frame] = frame_inputs
+            self.simulate(frame_inputs)
+        self.is_resimulating = False
+        elapsed_ms = (time.perf_counter() - start) * 1000.0
+        self.rollbacks += 1
+        self.resimulated_frames += self.frame - first
+        self.max_resimulation_ms = max(self.max_resimulation_ms, elapsed_ms)
+
+    def _update_checksum(self) -> None:
+        """Checksum the newest interval frame that can no longer be rolled back.
+
+        The state before frame f is final once every frame before f ran with
+        confirmed input. Called right after save_state(self.frame), so that
+        state and the max_rollback before it are still in the game's ring.
+
+        Returns:
+            None
+        """
+        if self.checksum is None:
+            return
+        final = min(min(self.confirmed) + 1, self.frame)
+        frame = final - final % self.checksum_interval
+        if frame in self.local_checksums or self.frame - frame >= self.snapshot_count():
+            return
+        self.local_checksums[frame] = self.checksum(frame)
+        self._compare_checksums(frame)
+        oldest = frame - 4 * self.checksum_interval
+        for checksums in (self.local_checksums, self.remote_checksums):
+            for old in [old for old in checksums if old < oldest]:
+                del checksums[old]
+
+    def _compare_checksums(self, frame: int) -> None:
+        """Compare the local and remote checksums of a frame once both are known.
+
+        Args:
+            frame: Checksummed frame.
+
+        Returns:
+            None
+        """
+        local = self.local_checksums.get(frame)
+        remote = self.remote_checksums.get(frame)
+        if local is None or remote is None:
+            return
+        if local == remote:
+            self.checksums_compared += 1
+        elif self.desync_frame is None:
+            self.desync_frame = frame
+
+    def _prune(self) -> None:
+        """Drop inputs and predictions no rollback can reach.
+
+        Returns:
+            None
+        """
+        oldest = self.frame - self.snapshot_count() - _MAX_PACKET_FRAMES
+        self.predicted.pop(oldest, None)
+        for player_inputs in self.inputs:
+            player_inputs.pop(oldest - 1, None)
+
+    def advance(self, local_values: List[float]) -> bool:
+        """Run one frame of the session.
+
+        Args:
+            local_values: The local player's action values this frame.
+
+        Returns:
+            True if a frame was simulated, False if the session stalled waiting for the peer.
+        """
+        self._receive()
+        self._rollback()
+
+        remote_confirmed = min(confirmed for player, confirmed in enumerate(self.confirmed)
+                               if player != self.local_player)
+        if self.frame - remote_confirmed > self.max_rollback:
+            self.stalled_frames += 1
+            self._send()
+            return False
+
+        target = self.frame + self.input_delay
+        self.inputs[self.local_player][target] = quantize([local_values])[0]
+        self.confirmed[self.local_player] = target
+        self._send()
+
+        self.save_state(self.frame)
+        self._update_checksum()
+        frame_inputs = self._frame_inputs(self.frame)
+        self.predicted[self.frame] = frame_inputs
+        self.simulate(frame_inputs)
+        self.frame += 1
+        self._prune()
+        return True
+
+    def get_summary(self) -> str:
+        """Describe rollback statistics for the session so far.
+
+        Returns:
+            One-line summary.
+        """
+        if self.desync_frame is not None:
+            sync = f"DESYNC at frame {self.desync_frame}"
+        else:
+            sync = f"{self.checksums_compared} checksums matched"
+        return (f"Netplay: {self.frame} frames, {self.rollbacks} rollbacks, "
+                f"{self.resimulated_frames} frames resimulated (max {self.max_resimulation_ms:.2f} ms), "
+                f"{self.stalled_frames} frames stalled, {sync}")
+
+    def close(self) -> None:
+        """Close the transport.
+
+        Returns:
+            None
+        """
+        self.transport.close()
@@ -1,11 +1,25 @@
 from __future__ import annotations
 
+import math
 from dataclasses import dataclass
-from typing import Tuple
+from typing import Any, Generator, List, Tuple
 
-from Box2D import b2Color, b2Draw
+from Box2D import b2ChainShape, b2CircleShape, b2Color, b2Draw, b2EdgeShape, b2PolygonShape
+import numpy as np
 import pyray as rl
 
+from engine import render
+
+# Box2D's own debug colors for each body state.
+STATIC_COLOR = b2Color(0.5, 0.9, 0.5)
+KINEMATIC_COLOR = b2Color(0.5, 0.5, 0.9)
+AWAKE_COLOR = b2Color(0.9, 0.7, 0.7)
+ASLEEP_COLOR = b2Color(0.6, 0.6, 0.6)
+INACTIVE_COLOR = b2Color(0.5, 0.5, 0.3)
+JOINT_COLOR = b2Color(0.5, 0.8, 0.8)
+
+CIRCLE_SEGMENTS = 16
+
 
 @dataclass
 class DebugDrawCtx:
@@ -13,6 +27,24 @@ class DebugDrawCtx:
     line_thickness: float = 1.0
 
 
+@dataclass
+class StaticShape:
+    """Fixture outlines and body transform captured for baking.
+
+    Attributes:
+        x: Body x in meters.
+        y: Body y in meters.
+        angle: Body angle in radians.
+        outlines: Outlines in body space, in meters.
+        solid: True for closed, filled outlines.
+    """
+    x: float
+    y: float
+    angle: float
+    outlines: List[List[Tuple[float, float]]]
+    solid: bool
+
+
 def _to_raylib_color(color: b2Color, alpha: float = 1.0) -> rl.Color:
     r = int(max(0, min(255, color.r * 255)))
     g = int(max(0, min(255, color.g * 255)))
@@ -21,10 +53,215 @@ def _to_raylib_color(color: b2Color, alpha: float = 1.0) -> rl.Color:
     return rl.Color(r, g, b, a)
 
 
+def _local_outlines(shape: Any) -> Tuple[List[List[Tuple[float, float]]], bool]:
+    """Get the outlines of a fixture shape in body space, in meters.
+
+    Args:
+        shape: Box2D shape.
+
+    Returns:
+        (outlines, solid): closed outlines for polygons and circles, open
+        polylines for edges and chains.
+    """
+    if isinstance(shape, b2CircleShape):
+        center_x, center_y = shape.pos
+        step = 2.0 * math.pi / CIRCLE_SEGMENTS
+        radius = shape.radius
+        return [[(center_x + math.cos(i * step) * radius, center_y + math.sin(i * step) * radius)
+                 for i in range(CIRCLE_SEGMENTS)]], True
+    if isinstance(shape, (b2EdgeShape, b2ChainShape)):
+        return [[tuple(vertex) for vertex in shape.vertices]], False
+    if isinstance(shape, b2PolygonShape):
+        return [[tuple(vertex) for vertex in shape.vertices]], True
+    return [], False
+
+
+def _shape_outlines(body: Any, shape: Any) -> Tuple[List[List[Tuple[float, float]]], bool]:
+    """Get the world-space outlines of a fixture shape, in meters.
+
+    Args:
+        body: Body owning the shape.
+        shape: Box2D shape.
+
+    Returns:
+        (outlines, solid), as for _local_outlines.
+    """
+    outlines, solid = _local_outlines(shape)
+    return [[tuple(body.GetWorldPoint(point)) for point in outline] for outline in outlines], solid
+
+
 class PhysicsDebugRenderer(b2Draw):
+    """Box2D debug renderer drawing with raylib.
+
+    The b2Draw callbacks draw one shape at a time, which is fine for a few
+    moving bodies. Static geometry, usually thousands of level edges, is
+    instead baked once into a triangle mesh with build_static (or over several
+    frames with capture_static and build_static_steps) and drawn with one draw
+    call per frame by draw_static.
+    """
     def __init__(self, meters_to_pixels: float = 30.0, line_thickness: float = 1.0) -> None:
         super().__init__()
         self.ctx = DebugDrawCtx(meters_to_pixels=meters_to_pixels, line_thickness=line_thickness)
+        self.static_mesh: Any = None
+        self.static_material: Any = None
+
+    def capture_static(self, bodies: List[Any]) -> List[StaticShape]:
+        """Read the shapes of static bodies for build_static_steps.
+
+        This is the only part of baking that touches Box2D, so the bodies may
+        be destroyed while the steps run.
+
+        Args:
+            bodies: Static bodies to bake.
+
+        Returns:
+            One StaticShape per fixture.
+        """
+        shapes = []
+        for body in bodies:
+            x, y = body.position
+            angle = body.angle
+            for fixture in body.fixtures:
+                outlines, solid = _local_outlines(fixture.shape)
+                shapes.append(StaticShape(x, y, angle, outlines, solid))
+        return shapes
+
+    def build_static(self, bodies: List[Any]) -> None:
+        """Bake the shapes of static bodies into the static mesh in one go.
+
+        Args:
+            bodies: Static bodies to bake. Replaces the previous mesh.
+
+        Returns:
+            None
+        """
+        for _ in self.build_static_steps(self.capture_static(bodies)):
+            pass
+
+    def build_static_steps(self, shapes: List[StaticShape],
+                           step_vertices: int = 2048) -> Generator[None, None, None]:
+        """Bake captured shapes into the static mesh, a few at a time.
+
+        Polygons and circles are filled and outlined like DrawSolidPolygon;
+        edges and chains become line quads like DrawSegment. Yields after every
+        step_vertices outline vertices, so it can run as a JobManager job; the
+        previous mesh is kept and drawn until the last step replaces it.
+
+        Args:
+            shapes: Shapes from capture_static.
+            step_vertices: Outline vertices to transform per step.
+
+        Returns:
+            Generator to advance until exhausted.
+        """
+        scale = self.ctx.meters_to_pixels
+        segments: List[Tuple[float, float, float, float]] = []
+        fills: List[Tuple[float, float]] = []
+        step = 0
+        for shape in shapes:
+            cos = math.cos(shape.angle) * scale
+            sin = math.sin(shape.angle) * scale
+            origin_x = shape.x * scale
+            origin_y = shape.y * scale
+            for outline in shape.outlines:
+                points = [(origin_x + cos * x - sin * y, origin_y + sin * x + cos * y) for x, y in outline]
+                count = len(points)
+                step += count
+                if count < 2:
+                    continue
+                if shape.solid:
+                    # Fan from the first point; Box2D polygons are convex.
+                    for i in range(1, count - 1):
+                        fills.extend((points[0], points[i], points[i + 1]))
+                    points.append(points[0])
+                segments.extend((a[0], a[1], b[0], b[1]) for a, b in zip(points, points[1:]))
+            if step >= step_vertices:
+                step = 0
+                yield
+        self.unload_static()
+        if not segments and not fills:
+            return
+
+        # Each segment is a quad of line_thickness width around it.
+        lines = np.array(segments, dtype=np.float32).reshape(-1, 4)
+        direction = lines[:, 2:4] - lines[:, 0:2]
+        length = np.maximum(np.hypot(direction[:, 0], direction[:, 1]), 1e-6)
+        half_width = (0.5 * self.ctx.line_thickness / length)[:, np.newaxis]
+        normal = np.stack((-direction[:, 1], direction[:, 0]), axis=1) * half_width
+        start, end = lines[:, 0:2], lines[:, 2:4]
+        quads = np.stack((start + normal, start - normal, end - normal,
+                          start + normal, end - normal, end + normal), axis=1)
+        fill_vertices = np.array(fills, dtype=np.float32).reshape(-1, 2)
+
+        count = len(fill_vertices) + quads.shape[0] * 6
+        vertices = np.zeros((count, 3), dtype=np.float32)
+        vertices[:len(fill_vertices), 0:2] = fill_vertices
+        vertices[len(fill_vertices):, 0:2] = quads.reshape(-1, 2)
+        colors = np.empty((count, 4), dtype=np.uint8)
+        fill, line = _to_raylib_color(STATIC_COLOR, 0.8), _to_raylib_color(STATIC_COLOR, 1.0)
+        colors[:len(fill_vertices)] = (fill.r, fill.g, fill.b, fill.a)
+        colors[len(fill_vertices):] = (line.r, line.g, line.b, line.a)
+
+        mesh = rl.Mesh()
+        mesh.vertexCount = count
+        mesh.triangleCount = count // 3
+        mesh.vertices = rl.ffi.cast("float *", rl.ffi.from_buffer(vertices))
+        mesh.colors = rl.ffi.cast("unsigned char *", rl.ffi.from_buffer(colors))
+        rl.upload_mesh(mesh, False)
+        # The GPU has its own copy; raylib must never free the NumPy buffers.
+        mesh.vertices = rl.ffi.NULL
+        mesh.colors = rl.ffi.NULL
+        self.static_mesh = mesh
+        if self.static_material is None:
+            self.static_material = rl.load_material_default()
+
+    def draw_static(self) -> None:
+        """Draw the baked static mesh, if any, in the current camera.
+
+        Returns:
+            None
+        """
+        if self.static_mesh is None:
+            return
+        # Flush batched shapes first so the order is kept, and draw both windings.
+        render.draw_render_batch_active()
+        rl.rl_disable_backface_culling()
+        render.draw_mesh(self.static_mesh, self.static_material, rl.matrix_identity())
+        rl.rl_enable_backface_culling()
+
+    def unload_static(self) -> None:
+        """Free the static mesh's GPU buffers.
+
+        Returns:
+            None
+        """
+        if self.static_mesh is not None:
+            rl.unload_mesh(self.static_mesh)
+            self.static_mesh = None
+
+    def draw_body(self, body: Any, color: b2Color) -> None:
+        """Draw the shapes of one body through the b2Draw callbacks.
+
+        Args:
+            body: Body to draw.
+            color: Box2D color for the body's state.
+
+        Returns:
+            None
+        """
+        for fixture in body.fixtures:
+            shape = fixture.shape
+            if isinstance(shape, b2CircleShape):
+                axis = body.GetWorldVector((1.0, 0.0))
+                self.DrawSolidCircle(body.GetWorldPoint(shape.pos), shape.radius, axis, color)
+                continue
+            outlines, solid = _shape_outlines(body, shape)
+            for outline in outlines:
+                if solid:
+                    self.DrawSolidPolygon(outline, color)
+                else:
+                    for a, b in zip(outline, outline[1:]):
+                        self.DrawSegment(a, b, color)
 
     def DrawPolygon(self, vertices, color):
         count = len(vertices)
@@ -36,7 +273,7 @@ class PhysicsDebugRenderer(b2Draw):
             p1 = vertices[(i + 1) % count]
             a = rl.Vector2(p0[0] * self.ctx.meters_to_pixels, p0[1] * self.ctx.meters_to_pixels)
             b = rl.Vector2(p1[0] * self.ctx.meters_to_pixels, p1[1] * self.ctx.meters_to_pixels)
-            rl.draw_line_ex(a, b, self.ctx.line_thickness, c)
+            render.draw_line_ex(a, b, self.ctx.line_thickness, c)
 
     def DrawSolidPolygon(self, vertices, color):
         count = len(vertices)
@@ -52,32 +289,32 @@ class PhysicsDebugRenderer(b2Draw):
         center.x /= count
         center.y /= count
         for i in range(count - 1):
-            rl.draw_triangle(pts[i], center, pts[i + 1], fill)
-        rl.draw_triangle(pts[count - 1], center, pts[0], fill)
+            render.draw_triangle(pts[i], center, pts[i + 1], fill)
+        render.draw_triangle(pts[count - 1], center, pts[0], fill)
         for i in range(count):
-            rl.draw_line_ex(pts[i], pts[(i + 1) % count], self.ctx.line_thickness, line)
+            render.draw_line_ex(pts[i], pts[(i + 1) % count], self.ctx.line_thickness, line)
 
     def DrawCircle(self, center, radius, color):
         c = _to_raylib_color(color)
-        rl.draw_circle_lines(int(center[0] * self.ctx.meters_to_pixels),
-                        int(center[1] * self.ctx.meters_to_pixels),
-                        radius * self.ctx.meters_to_pixels,
-                        c)
+        render.draw_circle_lines(int(center[0] * self.ctx.meters_to_pixels),
+                                 int(center[1] * self.ctx.meters_to_pixels),
+                                 radius * self.ctx.meters_to_pixels,
+                                 c)
 
     def DrawSolidCircle(self, center, radius, axis, color):
         fill = _to_raylib_color(color, 0.8)
         line = _to_raylib_color(color, 1.0)
         c = rl.Vector2(center[0] * self.ctx.meters_to_pixels, center[1] * self.ctx.meters_to_pixels)
-        rl.draw_circle_v(c, radius * self.ctx.meters_to_pixels, fill)
+        render.draw_circle_v(c, radius * self.ctx.meters_to_pixels, fill)
         axis_end = rl.Vector2((center[0] + axis[0] * radius) * self.ctx.meters_to_pixels,
                            (center[1] + axis[1] * radius) * self.ctx.meters_to_pixels)
-        rl.draw_line_ex(c, axis_end, self.ctx.line_thickness, line)
+        render.draw_line_ex(c, axis_end, self.ctx.line_thickness, line)
 
     def DrawSegment(self, p1, p2, color):
         c = _to_raylib_color(color)
         a = rl.Vector2(p1[0] * self.ctx.meters_to_pixels, p1[1] * self.ctx.meters_to_pixels)
         b = rl.Vector2(p2[0] * self.ctx.meters_to_pixels, p2[1] * self.ctx.meters_to_pixels)
-        rl.draw_line_ex(a, b, self.ctx.line_thickness, c)
+        render.draw_line_ex(a, b, self.ctx.line_thickness, c)
 
     def DrawTransform(self, xf):
         p = xf.position
@@ -86,9 +323,9 @@ class PhysicsDebugRenderer(b2Draw):
         origin = rl.Vector2(p[0] * self.ctx.meters_to_pixels, p[1] * self.ctx.meters_to_pixels)
         x_end = rl.Vector2((p[0] + x_axis[0]) * self.ctx.meters_to_pixels, (p[1] + x_axis[1]) * self.ctx.meters_to_pixels)
         y_end = rl.Vector2((p[0] + y_axis[0]) * self.ctx.meters_to_pixels, (p[1] + y_axis[1]) * self.ctx.meters_to_pixels)
-        rl.draw_line_ex(origin, x_end, self.ctx.line_thickness, rl.RED)
-        rl.draw_line_ex(origin, y_end, self.ctx.line_thickness, rl.GREEN)
+        render.draw_line_ex(origin, x_end, self.ctx.line_thickness, rl.RED)
+        render.draw_line_ex(origin, y_end, self.ctx.line_thickness, rl.GREEN)
 
     def DrawPoint(self, p, size, color):
         c = _to_raylib_color(color)
-        rl.draw_circle_v(rl.Vector2(p[0] * self.ctx.meters_to_pixels, p[1] * self.ctx.meters_to_pixels), size, c)
+        render.draw_circle_v(rl.Vector2(p[0] * self.ctx.meters_to_pixels, p[1] * self.ctx.meters_to_pixels), size, c)
@@ -1,17 +1,23 @@
 from __future__ import annotations
 
 import math
-from typing import Any, Dict, List, Optional
+import os
+from typing import Any, Dict, List, Optional, Tuple
 
 from Box2D import (b2Body, b2CircleShape, b2FixtureDef, b2PolygonShape,
                    b2Vec2)
+import numpy as np
 import pyray as rl
 
+from engine import render
+from engine.ecs import EcsField
 from engine.framework import Component
-from engine.math_extensions import vec_add, vec_div, vec_len, vec_mul, vec_normalize, vec_sub, v2
-from engine.raycasts import raycast_closest
+from engine.math_extensions import Vec2, vec_add, vec_div, vec_len, vec_mul, vec_normalize, vec_sub, v2
+from engine.raycasts import ShapeHit, raycast_closest, shape_cast
+from engine.spritesheets import SheetTag, grid_rects, load_aseprite
 from engine.prefabs.managers import FontManager
-from engine.prefabs.services import PhysicsService, SoundService, TextureService
+from engine.prefabs.services import (AnimationSystem, CrowdService, PhysicsService, SoundService, TextureService,
+                                     TimerService, TransformService)
 
 
 class MultiComponent(Component):
@@ -53,6 +59,7 @@ class MultiComponent(Component):
             None
         """
         for component in self.components.values():
+            render.stats.owner = type(component)
             component.draw()
 
     def add_component(self, name: str, component_or_cls: Any, *args: Any, **kwargs: Any) -> Component:
@@ -127,12 +134,12 @@ class TextComponent(Component):
         """
         if not self.font_manager:
             return
-        rl.draw_text_ex(self.font_manager.get_font(self.font_name),
-                   self.text,
-                   self.position,
-                   float(self.font_size),
-                   1.0,
-                   self.color)
+        render.draw_text_ex(self.font_manager.get_font(self.font_name),
+                            self.text,
+                            self.position,
+                            float(self.font_size),
+                            1.0,
+                            self.color)
 
     def set_text(self, text: str) -> None:
         """Set the displayed text.
@@ -314,9 +321,10 @@ class BodyComponent(Component):
         self.body = body
         self.build = build
         self.physics: Optional[PhysicsService] = None
+        self.slot = -1
 
     def init(self) -> None:
-        """Resolve PhysicsService and build the body if provided.
+        """Resolve PhysicsService, build the body if provided, and register it for transform sync.
 
         Returns:
             None
@@ -326,6 +334,26 @@ class BodyComponent(Component):
         self.physics = self.owner.scene.get_service(PhysicsService)
         if self.build:
             self.build(self)
+        if self.slot < 0:
+            self.slot = self.physics.register_body(self)
+        else:
+            self.physics.refresh_body(self.slot)
+
+    def follow(self, follower: Any, follow_rotation: bool = True) -> None:
+        """Have a component's position (and rotation) track this body after each step.
+
+        Args:
+            follower: Object with position and rotation attributes, such as a SpriteComponent.
+            follow_rotation: True to copy the body angle too.
+
+        Returns:
+            None
+        """
+        if not self.physics:
+            self.physics = self.owner.scene.get_service(PhysicsService)
+        if self.slot < 0:
+            self.slot = self.physics.register_body(self)
+        self.physics.add_follower(self.slot, follower, follow_rotation)
 
     def enable(self) -> None:
         """Enable the body in the physics simulation.
@@ -355,13 +383,16 @@ class BodyComponent(Component):
         return self.body.position if self.body else b2Vec2(0.0, 0.0)
 
     def get_position_pixels(self) -> rl.Vector2:
-        """Get position in pixels.
+        """Get position in pixels, from the transform cache.
 
         Returns:
             Vector2 position in pixels.
         """
         if not self.physics or not self.body:
             return v2(0.0, 0.0)
+        if self.slot >= 0:
+            x, y = self.physics.positions[self.slot]
+            return v2(x, y)
         pos = self.physics.convert_to_pixels(self.body.position)
         return v2(pos.x, pos.y)
 
@@ -382,6 +413,8 @@ class BodyComponent(Component):
             if not self.physics:
                 return
             self.body.position = self.physics.convert_to_meters(pos)
+        if self.slot >= 0:
+            self.physics.refresh_body(self.slot)
 
     def set_rotation(self, degrees: float) -> None:
         """Set rotation in degrees.
@@ -394,6 +427,8 @@ class BodyComponent(Component):
         """
         if self.body:
             self.body.angle = math.radians(degrees)
+            if self.slot >= 0 and self.physics:
+                self.physics.refresh_body(self.slot)
 
     def get_velocity_meters(self) -> b2Vec2:
         """Get linear velocity in meters/sec.
@@ -414,6 +449,21 @@ class BodyComponent(Component):
         vel = self.physics.convert_to_pixels(self.body.linearVelocity)
         return v2(vel.x, vel.y)
 
+    def read_velocity_pixels(self, out: Vec2) -> Vec2:
+        """Read linear velocity in pixels/sec into an existing vector.
+
+        Args:
+            out: Vector to write into.
+
+        Returns:
+            out.
+        """
+        if not self.physics or not self.body:
+            return out.set(0.0, 0.0)
+        vel = self.body.linearVelocity
+        scale = self.physics.meters_to_pixels
+        return out.set(vel.x * scale, vel.y * scale)
+
     def set_velocity(self, vel) -> None:
         """Set linear velocity (meters if b2Vec2, else pixels).
 
@@ -430,15 +480,20 @@ class BodyComponent(Component):
         else:
             if not self.physics:
                 return
-            self.body.linearVelocity = self.physics.convert_to_meters(vel)
+            scale = self.physics.pixels_to_meters
+            self.body.linearVelocity = (vel.x * scale, vel.y * scale)
 
     def get_rotation(self) -> float:
-        """Get rotation in degrees.
+        """Get rotation in degrees, from the transform cache.
 
         Returns:
             Rotation in degrees.
         """
-        return math.degrees(self.body.angle) if self.body else 0.0
+        if not self.body:
+            return 0.0
+        if self.slot >= 0 and self.physics:
+            return float(self.physics.angles[self.slot])
+        return math.degrees(self.body.angle)
 
     def get_contacts(self) -> List[b2Body]:
         """Get bodies currently touching this body.
@@ -455,6 +510,8 @@ class BodyComponent(Component):
                 other = edge.other
                 if other not in contacts:
                     contacts.append(other)
+        if len(contacts) > 1 and self.physics:
+            contacts.sort(key=self.physics.body_sort_key)
         return contacts
 
     def get_sensor_overlaps(self) -> List[b2Body]:
@@ -478,17 +535,236 @@ class BodyComponent(Component):
             elif fixture_b.body == self.body and fixture_b.sensor:
                 if fixture_a.body not in contacts:
                     contacts.append(fixture_a.body)
+        if len(contacts) > 1 and self.physics:
+            contacts.sort(key=self.physics.body_sort_key)
         return contacts
 
 
+class TransformComponent(Component):
+    """Position, rotation, and scale relative to a parent. Depends on TransformService.
+
+    The parent is another TransformComponent, a BodyComponent (the transform
+    then follows the body), or None (local is world). World values are
+    recomputed by TransformService only when the transform or one of its
+    ancestors changed; reading them resolves pending changes first. Linked
+    followers (for example a SpriteComponent) receive the world position and
+    rotation whenever it is recomputed.
+
+    Attributes:
+        local_position: Offset from the parent in the parent's space, in pixels.
+        local_rotation: Rotation relative to the parent in degrees.
+        local_scale: Scale relative to the parent.
+        world_position: Position in pixels.
+        world_rotation: Rotation in degrees.
+        world_scale: Scale.
+        parent: Parent transform or body, or None.
+        children: Transforms parented to this one.
+    """
+    def __init__(self,
+                 parent: Optional[Any] = None,
+                 position: Optional[rl.Vector2] = None,
+                 rotation: float = 0.0,
+                 scale: float = 1.0) -> None:
+        """Create the transform.
+
+        Args:
+            parent: TransformComponent or BodyComponent to attach to, or None.
+            position: Local position in pixels.
+            rotation: Local rotation in degrees.
+            scale: Local scale.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.local_position = v2(position.x, position.y) if position else v2(0.0, 0.0)
+        self.local_rotation = rotation
+        self.local_scale = scale
+        self.world_position = v2(0.0, 0.0)
+        self.world_rotation = 0.0
+        self.world_scale = 1.0
+        self.parent: Optional[Any] = None
+        self.children: List[TransformComponent] = []
+        self.followers: List[Tuple[Any, bool]] = []
+        self.is_dirty = True
+        self.service: Optional[TransformService] = None
+        self.initial_parent = parent
+
+    def init(self) -> None:
+        """Resolve TransformService and attach to the initial parent.
+
+        Returns:
+            None
+        """
+        if not self.owner or not self.owner.scene:
+            return
+        self.service = self.owner.scene.get_service(TransformService)
+        self.set_parent(self.initial_parent)
+
+    def set_parent(self, parent: Optional[Any]) -> None:
+        """Attach to a new parent, keeping the local transform.
+
+        Args:
+            parent: TransformComponent, BodyComponent, or None.
+
+        Returns:
+            None
+        """
+        if isinstance(self.parent, TransformComponent):
+            self.parent.children.remove(self)
+        elif isinstance(self.parent, BodyComponent) and self.service:
+            self.service.remove_root(self)
+        self.parent = parent
+        if isinstance(parent, TransformComponent):
+            parent.children.append(self)
+        elif isinstance(parent, BodyComponent) and self.service:
+            self.service.add_root(self)
+        self.mark_dirty()
+
+    def mark_dirty(self) -> None:
+        """Schedule this transform and its subtree for recomputation.
+
+        Returns:
+            None
+        """
+        if self.service:
+            self.service.mark_dirty(self)
+        else:
+            self.is_dirty = True
+
+    def set_local_position(self, position: rl.Vector2) -> None:
+        """Set the offset from the parent.
+
+        Args:
+            position: Local position in pixels.
+
+        Returns:
+            None
+        """
+        if position.x != self.local_position.x or position.y != self.local_position.y:
+            self.local_position.x = position.x
+            self.local_position.y = position.y
+            self.mark_dirty()
+
+    def set_local_rotation(self, rotation: float) -> None:
+        """Set the rotation relative to the parent.
+
+        Args:
+            rotation: Degrees.
+
+        Returns:
+            None
+        """
+        if rotation != self.local_rotation:
+            self.local_rotation = rotation
+            self.mark_dirty()
+
+    def set_local_scale(self, scale: float) -> None:
+        """Set the scale relative to the parent.
+
+        Args:
+            scale: Scale multiplier.
+
+        Returns:
+            None
+        """
+        if scale != self.local_scale:
+            self.local_scale = scale
+            self.mark_dirty()
+
+    def follow(self, follower: Any, follow_rotation: bool = True) -> None:
+        """Have a component's position (and rotation) track this transform.
+
+        Args:
+            follower: Object with position and rotation attributes, such as a SpriteComponent.
+            follow_rotation: True to copy the world rotation too.
+
+        Returns:
+            None
+        """
+        # Followers are written in place, so they must not share a Vector2.
+        follower.position = v2(self.world_position.x, self.world_position.y)
+        if follow_rotation:
+            follower.rotation = self.world_rotation
+        self.followers.append((follower, follow_rotation))
+
+    def compute_world(self) -> None:
+        """Recompute world values from the parent's, assuming the parent is current.
+
+        Returns:
+            None
+        """
+        parent = self.parent
+        if isinstance(parent, TransformComponent):
+            parent_x = parent.world_position.x
+            parent_y = parent.world_position.y
+            parent_rotation = parent.world_rotation
+            parent_scale = parent.world_scale
+        elif isinstance(parent, BodyComponent) and parent.physics and parent.slot >= 0:
+            parent_x, parent_y = parent.physics.positions[parent.slot].tolist()
+            parent_rotation = float(parent.physics.angles[parent.slot])
+            parent_scale = 1.0
+        else:
+            parent_x = parent_y = parent_rotation = 0.0
+            parent_scale = 1.0
+        local_x = self.local_position.x * parent_scale
+        local_y = self.local_position.y * parent_scale
+        if parent_rotation:
+            radians = math.radians(parent_rotation)
+            cos_r = math.cos(radians)
+            sin_r = math.sin(radians)
+            local_x, local_y = local_x * cos_r - local_y * sin_r, local_x * sin_r + local_y * cos_r
+        world = self.world_position
+        world.x = parent_x + local_x
+        world.y = parent_y + local_y
+        self.world_rotation = parent_rotation + self.local_rotation
+        self.world_scale = parent_scale * self.local_scale
+        self.is_dirty = False
+        for follower, follow_rotation in self.followers:
+            follower.position.x = world.x
+            follower.position.y = world.y
+            if follow_rotation:
+                follower.rotation = self.world_rotation
+
+    def resolve(self) -> None:
+        """Apply pending changes of this transform or its ancestors.
+
+        Returns:
+            None
+        """
+        if self.service:
+            self.service.resolve(self)
+        elif self.is_dirty:
+            self.compute_world()
+
+    def get_world_position(self) -> rl.Vector2:
+        """Get the world position.
+
+        Returns:
+            A new Vector2 in pixels.
+        """
+        self.resolve()
+        return v2(self.world_position.x, self.world_position.y)
+
+    def get_world_rotation(self) -> float:
+        """Get the world rotation.
+
+        Returns:
+            Degrees.
+        """
+        self.resolve()
+        return self.world_rotation
+
+
 class SpriteComponent(Component):
     """Component for rendering a sprite. Depends on TextureService."""
-    def __init__(self, filename: str, body: Optional[BodyComponent] = None) -> None:
+    def __init__(self, filename: str, body: Optional[BodyComponent] = None, follow_rotation: bool = True) -> None:
         """  init  .
         
         Args:
             filename: Parameter.
-            body: Parameter.
+            body: Body to follow; its transform is pushed here after each physics step.
+            follow_rotation: False to keep the rotation set with set_rotation.
         
         Returns:
             None
@@ -496,6 +772,7 @@ class SpriteComponent(Component):
         super().__init__()
         self.filename = filename
         self.body = body
+        self.follow_rotation = follow_rotation
         self.sprite: Optional[rl.Texture2D] = None
         self.position = v2(0.0, 0.0)
         self.rotation = 0.0
@@ -512,6 +789,8 @@ class SpriteComponent(Component):
         if self.owner and self.owner.scene:
             texture_service = self.owner.scene.get_service(TextureService)
             self.sprite = texture_service.get_texture(self.filename)
+            if self.body:
+                self.body.follow(self, self.follow_rotation)
 
     def draw(self) -> None:
         """Draw the sprite if active.
@@ -521,16 +800,13 @@ class SpriteComponent(Component):
         """
         if not self.is_active or not self.sprite:
             return
-        if self.body:
-            self.position = self.body.get_position_pixels()
-            self.rotation = self.body.get_rotation()
         source = rl.Rectangle(0.0, 0.0, float(self.sprite.width), float(self.sprite.height))
         dest = rl.Rectangle(self.position.x, self.position.y,
                          float(self.sprite.width) * self.scale,
                          float(self.sprite.height) * self.scale)
         origin = v2(float(self.sprite.width) / 2.0 * self.scale,
                     float(self.sprite.height) / 2.0 * self.scale)
-        rl.draw_texture_pro(self.sprite, source, dest, origin, self.rotation, self.tint)
+        render.draw_texture_pro(self.sprite, source, dest, origin, self.rotation, self.tint)
 
     def set_position(self, position: rl.Vector2) -> None:
         """Set the sprite position in pixels.
@@ -589,25 +865,38 @@ class SpriteComponent(Component):
 
 
 class Animation:
-    """Frame-based animation helper."""
-    def __init__(self, frames: List[rl.Texture2D], fps: float = 15.0, loop: bool = True) -> None:
+    """Frame-based animation helper.
+
+    Frames are either whole textures or source rectangles into a shared atlas
+    texture, and can use one fps for every frame or per-frame durations.
+    """
+    def __init__(self, frames: List[rl.Texture2D], fps: float = 15.0, loop: bool = True,
+                 sources: Optional[List[rl.Rectangle]] = None,
+                 durations: Optional[List[float]] = None) -> None:
         """  init  .
         
         Args:
-            frames: Parameter.
+            frames: Texture per frame (the same atlas texture repeated when using sources).
             fps: Parameter.
             loop: Parameter.
+            sources: Optional source rectangle per frame; defaults to the whole texture.
+            durations: Optional seconds per frame; overrides fps when set.
         
         Returns:
             None
         """
         self.frames = frames
         self.fps = fps
-        self.frame_timer = 1.0 / fps if fps > 0 else 0.0
+        self.sources = sources
+        self.durations = durations
+        self._frame_timer = self.frame_duration(0)
         self.loop = loop
-        self.current_frame = 0
+        self._current_frame = 0
         self.playing = True
         self.is_active = True
+        self.is_current = True
+        self.system: Optional[AnimationSystem] = None
+        self.slot = -1
 
     @classmethod
     def from_files(cls, texture_service: TextureService, filenames: List[str], fps: float = 15.0, loop: bool = True):
@@ -625,6 +914,175 @@ class Animation:
         frames = [texture_service.get_texture(name) for name in filenames]
         return cls(frames, fps, loop)
 
+    @classmethod
+    def from_sheet(cls, texture_service: TextureService, filename: str, frame_width: int, frame_height: int,
+                   start: int = 0, count: Optional[int] = None, fps: float = 15.0, loop: bool = True,
+                   margin: int = 0, spacing: int = 0) -> Animation:
+        """Create an animation from cells of a strip or grid spritesheet.
+
+        Cells are numbered left to right, top to bottom.
+
+        Args:
+            texture_service: TextureService used to load the sheet once.
+            filename: Path to the sheet image.
+            frame_width: Cell width in pixels.
+            frame_height: Cell height in pixels.
+            start: Index of the first cell.
+            count: Number of cells, or None for the rest of the sheet.
+            fps: Frames per second.
+            loop: True to loop.
+            margin: Pixels around the outside of the grid.
+            spacing: Pixels between cells.
+
+        Returns:
+            The created Animation.
+        """
+        texture = texture_service.get_texture(filename)
+        rects = grid_rects(texture.width, texture.height, frame_width, frame_height, start, count, margin, spacing)
+        return cls([texture] * len(rects), fps, loop, sources=[rl.Rectangle(*rect) for rect in rects])
+
+    @classmethod
+    def from_aseprite(cls, texture_service: TextureService, filename: str, loop: bool = True) -> Dict[str, Animation]:
+        """Create animations from an Aseprite JSON export, one per frame tag.
+
+        Per-frame durations from the export are kept. A sheet without tags yields
+        a single animation named after the JSON file.
+
+        Args:
+            texture_service: TextureService used to load the sheet once.
+            filename: Path to the JSON export.
+            loop: True to loop.
+
+        Returns:
+            Mapping of tag name to Animation.
+        """
+        sheet = load_aseprite(filename)
+        texture = texture_service.get_texture(sheet.image)
+        tags = sheet.tags or [SheetTag(os.path.splitext(os.path.basename(filename))[0], list(range(len(sheet.frames))))]
+        animations: Dict[str, Animation] = {}
+        for tag in tags:
+            frames = [sheet.frames[index] for index in tag.frames]
+            animations[tag.name] = cls([texture] * len(frames), 0.0, loop,
+                                       sources=[rl.Rectangle(*frame.rect) for frame in frames],
+                                       durations=[frame.duration for frame in frames])
+        return animations
+
+    def frame_duration(self, index: int) -> float:
+        """Get how long a frame is shown.
+
+        Args:
+            index: Frame index.
+
+        Returns:
+            Seconds, or 0.0 if the animation does not advance.
+        """
+        if self.durations:
+            return self.durations[index]
+        return 1.0 / self.fps if self.fps > 0 else 0.0
+
+    def is_timed(self) -> bool:
+        """Check if the animation advances at all.
+
+        Returns:
+            True if there are per-frame durations or a positive fps.
+        """
+        return bool(self.durations) or self.fps > 0
+
+    def get_source(self, index: int) -> rl.Rectangle:
+        """Get the source rectangle of a frame.
+
+        Args:
+            index: Frame index.
+
+        Returns:
+            The atlas rectangle, or the whole texture.
+        """
+        if self.sources:
+            return self.sources[index]
+        sprite = self.frames[index]
+        return rl.Rectangle(0.0, 0.0, float(sprite.width), float(sprite.height))
+
+    @property
+    def current_frame(self) -> int:
+        """Current frame index, read from the AnimationSystem when bound.
+
+        Returns:
+            The frame index.
+        """
+        if self.system:
+            return int(self.system.frames[self.slot])
+        return self._current_frame
+
+    @current_frame.setter
+    def current_frame(self, frame: int) -> None:
+        if self.system:
+            self.system.frames[self.slot] = frame
+        else:
+            self._current_frame = frame
+
+    @property
+    def frame_timer(self) -> float:
+        """Seconds left on the current frame, read from the AnimationSystem when bound.
+
+        Returns:
+            The frame timer in seconds.
+        """
+        if self.system:
+            return float(self.system.timers[self.slot])
+        return self._frame_timer
+
+    @frame_timer.setter
+    def frame_timer(self, timer: float) -> None:
+        if self.system:
+            self.system.timers[self.slot] = timer
+        else:
+            self._frame_timer = timer
+
+    def bind(self, system: AnimationSystem) -> None:
+        """Move the frame state into an AnimationSystem slot.
+
+        Once bound, update() does nothing and the system advances the animation.
+
+        Args:
+            system: AnimationSystem that will advance this animation.
+
+        Returns:
+            None
+        """
+        if self.system:
+            return
+        frame = self._current_frame
+        timer = self._frame_timer
+        self.slot = system.add([self.frame_duration(i) for i in range(len(self.frames))], self.loop)
+        self.system = system
+        self.current_frame = frame
+        self.frame_timer = timer
+        self._sync()
+
+    def unbind(self) -> None:
+        """Copy the frame state back from the AnimationSystem and release the slot.
+
+        Returns:
+            None
+        """
+        if not self.system:
+            return
+        self._current_frame = self.current_frame
+        self._frame_timer = self.frame_timer
+        self.system.remove(self.slot)
+        self.system = None
+        self.slot = -1
+
+    def _sync(self) -> None:
+        """Push the running state to the AnimationSystem slot.
+
+        Returns:
+            None
+        """
+        if self.system:
+            self.system.running[self.slot] = (self.playing and self.is_active and self.is_current
+                                              and self.is_timed() and bool(self.frames))
+
     def update(self, delta_time: float) -> None:
         """Advance the animation by delta time.
 
@@ -634,14 +1092,18 @@ class Animation:
         Returns:
             None
         """
-        if not self.frames or not self.playing or not self.is_active or self.fps <= 0:
+        if self.system:
+            return
+        if not self.frames or not self.playing or not self.is_active or not self.is_timed():
             return
-        self.frame_timer -= delta_time
-        if self.frame_timer <= 0.0:
-            self.frame_timer = 1.0 / self.fps
-            self.current_frame += 1
-        if self.current_frame > len(self.frames) - 1:
-            self.current_frame = 0 if self.loop else len(self.frames) - 1
+        self._frame_timer -= delta_time
+        if self._frame_timer <= 0.0:
+            self._current_frame += 1
+            if self._current_frame > len(self.frames) - 1:
+                self._current_frame = 0 if self.loop else len(self.frames) - 1
+            self._frame_timer = self.frame_duration(self._current_frame)
+        if self._current_frame > len(self.frames) - 1:
+            self._current_frame = 0 if self.loop else len(self.frames) - 1
 
     def draw(self, position: rl.Vector2, rotation: float = 0.0, tint: rl.Color = rl.WHITE) -> None:
         """Draw the animation at a position.
@@ -656,13 +1118,14 @@ class Animation:
         """
         if not self.is_active or not self.frames:
             return
-        sprite = self.frames[self.current_frame]
-        rl.draw_texture_pro(sprite,
-                       rl.Rectangle(0.0, 0.0, float(sprite.width), float(sprite.height)),
-                       rl.Rectangle(position.x, position.y, float(sprite.width), float(sprite.height)),
-                       v2(float(sprite.width) / 2.0, float(sprite.height) / 2.0),
-                       rotation,
-                       tint)
+        frame = self.current_frame
+        source = self.get_source(frame)
+        render.draw_texture_pro(self.frames[frame],
+                                source,
+                                rl.Rectangle(position.x, position.y, source.width, source.height),
+                                v2(source.width / 2.0, source.height / 2.0),
+                                rotation,
+                                tint)
 
     def draw_with_origin(self, position: rl.Vector2, origin: rl.Vector2, rotation: float = 0.0,
                          scale: float = 1.0, flip_x: bool = False, flip_y: bool = False,
@@ -683,14 +1146,15 @@ class Animation:
         """
         if not self.is_active or not self.frames:
             return
-        sprite = self.frames[self.current_frame]
-        src = rl.Rectangle(0.0, 0.0,
-                        float(sprite.width) * (-1.0 if flip_x else 1.0),
-                        float(sprite.height) * (-1.0 if flip_y else 1.0))
+        frame = self.current_frame
+        source = self.get_source(frame)
+        src = rl.Rectangle(source.x, source.y,
+                        source.width * (-1.0 if flip_x else 1.0),
+                        source.height * (-1.0 if flip_y else 1.0))
         dest = rl.Rectangle(position.x, position.y,
-                         float(sprite.width) * scale,
-                         float(sprite.height) * scale)
-        rl.draw_texture_pro(sprite, src, dest, vec_mul(origin, scale), rotation, tint)
+                         source.width * scale,
+                         source.height * scale)
+        render.draw_texture_pro(self.frames[frame], src, dest, vec_mul(origin, scale), rotation, tint)
 
     def play(self) -> None:
         """Start or resume playback.
@@ -699,6 +1163,7 @@ class Animation:
             None
         """
         self.playing = True
+        self._sync()
 
     def pause(self) -> None:
         """Pause playback.
@@ -707,6 +1172,7 @@ class Animation:
             None
         """
         self.playing = False
+        self._sync()
 
     def stop(self) -> None:
         """Stop playback and reset to the first frame.
@@ -715,22 +1181,51 @@ class Animation:
             None
         """
         self.playing = False
-        self.frame_timer = 1.0 / self.fps if self.fps > 0 else 0.0
+        self.frame_timer = self.frame_duration(0)
         self.current_frame = 0
+        self._sync()
+
+    def set_active(self, active: bool) -> None:
+        """Enable or disable updating and drawing.
+
+        Args:
+            active: True to enable, False to disable.
+
+        Returns:
+            None
+        """
+        self.is_active = active
+        self._sync()
+
+    def set_current(self, current: bool) -> None:
+        """Mark the animation as the one its controller is showing.
+
+        Only the current animation advances, matching AnimationController.update.
+
+        Args:
+            current: True if this is the controller's current animation.
+
+        Returns:
+            None
+        """
+        self.is_current = current
+        self._sync()
 
 
 class AnimationController(Component):
     """Component for controlling animations. Depends on TextureService."""
-    def __init__(self, body: Optional[BodyComponent] = None) -> None:
+    def __init__(self, body: Optional[BodyComponent] = None, follow_rotation: bool = True) -> None:
         """  init  .
         
         Args:
-            body: Parameter.
+            body: Body to follow; its transform is pushed here after each physics step.
+            follow_rotation: False to keep the rotation set directly.
         
         Returns:
             None
         """
         super().__init__()
+        self.follow_rotation = follow_rotation
         self.animations: Dict[str, Animation] = {}
         self.current_animation: Optional[Animation] = None
         self.position = v2(0.0, 0.0)
@@ -740,28 +1235,37 @@ class AnimationController(Component):
         self.flip_x = False
         self.flip_y = False
         self.body = body
+        self.system: Optional[AnimationSystem] = None
 
     def update(self, delta_time: float) -> None:
         """Update the current animation.
 
+        Animations bound to an AnimationSystem are advanced by the system instead.
+
         Args:
             delta_time: Seconds since the last frame.
 
         Returns:
             None
         """
-        if self.current_animation:
+        if self.current_animation and not self.system:
             self.current_animation.update(delta_time)
 
+    def init(self) -> None:
+        """Start following the linked body.
+
+        Returns:
+            None
+        """
+        if self.body and self.owner and self.owner.scene:
+            self.body.follow(self, self.follow_rotation)
+
     def draw(self) -> None:
         """Draw the current animation.
 
         Returns:
             None
         """
-        if self.body:
-            self.position = self.body.get_position_pixels()
-            self.rotation = self.body.get_rotation()
         if self.current_animation:
             self.current_animation.draw_with_origin(self.position, self.origin, self.rotation, self.scale,
                                                     self.flip_x, self.flip_y)
@@ -777,10 +1281,15 @@ class AnimationController(Component):
             None
         """
         self.animations[name] = animation
+        if not self.system and self.owner and self.owner.scene and self.owner.scene.has_service(AnimationSystem):
+            self.system = self.owner.scene.get_service(AnimationSystem)
+        if self.system:
+            animation.bind(self.system)
         if not self.current_animation:
             self.current_animation = animation
-            sprite = animation.frames[animation.current_frame]
-            self.origin = v2(float(sprite.width) / 2.0, float(sprite.height) / 2.0)
+            source = animation.get_source(animation.current_frame)
+            self.origin = v2(source.width / 2.0, source.height / 2.0)
+        animation.set_current(animation is self.current_animation)
 
     def add_animation_from_files(self, name: str, filenames: List[str], fps: float = 15.0, loop: bool = True) -> Animation:
         """Create an Animation from files and add it.
@@ -801,6 +1310,49 @@ class AnimationController(Component):
         self.add_animation(name, animation)
         return animation
 
+    def add_animation_from_sheet(self, name: str, filename: str, frame_width: int, frame_height: int,
+                                 start: int = 0, count: Optional[int] = None, fps: float = 15.0,
+                                 loop: bool = True) -> Animation:
+        """Create an Animation from cells of a strip or grid spritesheet and add it.
+
+        Args:
+            name: Animation name.
+            filename: Path to the sheet image.
+            frame_width: Cell width in pixels.
+            frame_height: Cell height in pixels.
+            start: Index of the first cell, numbered left to right, top to bottom.
+            count: Number of cells, or None for the rest of the sheet.
+            fps: Frames per second.
+            loop: True to loop.
+
+        Returns:
+            The created Animation.
+        """
+        texture_service = self.owner.scene.get_service(TextureService) if self.owner and self.owner.scene else None
+        if not texture_service:
+            raise RuntimeError("TextureService not available")
+        animation = Animation.from_sheet(texture_service, filename, frame_width, frame_height, start, count, fps, loop)
+        self.add_animation(name, animation)
+        return animation
+
+    def add_animations_from_aseprite(self, filename: str, loop: bool = True) -> Dict[str, Animation]:
+        """Create one Animation per tag of an Aseprite JSON export and add them.
+
+        Args:
+            filename: Path to the JSON export.
+            loop: True to loop.
+
+        Returns:
+            Mapping of tag name to the created Animation.
+        """
+        texture_service = self.owner.scene.get_service(TextureService) if self.owner and self.owner.scene else None
+        if not texture_service:
+            raise RuntimeError("TextureService not available")
+        animations = Animation.from_aseprite(texture_service, filename, loop)
+        for name, animation in animations.items():
+            self.add_animation(name, animation)
+        return animations
+
     def get_animation(self, name: str) -> Optional[Animation]:
         """Get an animation by name.
 
@@ -824,10 +1376,26 @@ class AnimationController(Component):
         if name:
             animation = self.animations.get(name)
             if animation:
-                self.current_animation = animation
+                self.set_animation(animation)
         if self.current_animation:
             self.current_animation.play()
 
+    def set_animation(self, animation: Animation) -> None:
+        """Switch the current animation without changing its play state.
+
+        Args:
+            animation: Animation to show, normally one added to this controller.
+
+        Returns:
+            None
+        """
+        if animation is self.current_animation:
+            return
+        if self.current_animation:
+            self.current_animation.set_current(False)
+        self.current_animation = animation
+        animation.set_current(True)
+
     def pause(self) -> None:
         """Pause the current animation.
 
@@ -925,6 +1493,233 @@ class AnimationController(Component):
         self.flip_y = flip
 
 
+class AnimationStateMachine(Component):
+    """Declarative animation state machine that drives an AnimationController.
+
+    States, parameters, and transitions are declared by name, then compiled in
+    init() into integer-indexed tables. Evaluating the machine each frame reads
+    parameters by index and only touches the controller when the state changes.
+
+    Conditions are (parameter, operator, value) tuples where operator is one of
+    ">", ">=", "<", "<=", "==", "!=". Transitions from "*" apply to any state.
+    """
+    ANY_STATE = "*"
+    _OPS = {">": 0, ">=": 1, "<": 2, "<=": 3, "==": 4, "!=": 5}
+
+    def __init__(self, controller: AnimationController) -> None:
+        """Create an empty state machine for a controller.
+
+        Args:
+            controller: AnimationController whose animations the states play.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.controller = controller
+        self.parameter_names: List[str] = []
+        self.values: List[float] = []
+        self.state_names: List[str] = []
+        self.state_animations: List[str] = []
+        self.state_restarts: List[bool] = []
+        self.transition_defs: List[tuple] = []
+        self.initial_state = ""
+        self.state = -1
+        self.animations: List[Animation] = []
+        self.transitions: List[List[tuple]] = []
+        self.any_transitions: List[tuple] = []
+
+    def add_parameter(self, name: str, default: float = 0.0) -> int:
+        """Declare a parameter that transitions can test.
+
+        Args:
+            name: Parameter name.
+            default: Initial value. Booleans are stored as 1.0/0.0.
+
+        Returns:
+            The parameter index to pass to set_parameter.
+        """
+        if name in self.parameter_names:
+            return self.parameter_names.index(name)
+        self.parameter_names.append(name)
+        self.values.append(float(default))
+        return len(self.values) - 1
+
+    def add_state(self, name: str, animation_name: Optional[str] = None, restart: bool = False) -> None:
+        """Declare a state that plays an animation from the controller.
+
+        Args:
+            name: State name.
+            animation_name: Controller animation to play, defaults to the state name.
+            restart: True to rewind the animation each time the state is entered.
+
+        Returns:
+            None
+        """
+        self.state_names.append(name)
+        self.state_animations.append(animation_name or name)
+        self.state_restarts.append(restart)
+        if not self.initial_state:
+            self.initial_state = name
+
+    def add_transition(self, from_state: str, to_state: str, conditions: Optional[List[tuple]] = None,
+                       exit_time: float = -1.0) -> None:
+        """Declare a transition between two states.
+
+        Transitions are tested in the order they were added, any-state transitions first.
+
+        Args:
+            from_state: Source state name, or "*" for any state.
+            to_state: Target state name.
+            conditions: List of (parameter, operator, value) tuples that must all hold.
+            exit_time: If >= 0, the fraction of the current animation that must have played.
+
+        Returns:
+            None
+        """
+        self.transition_defs.append((from_state, to_state, list(conditions or []), exit_time))
+
+    def set_initial_state(self, name: str) -> None:
+        """Set the state entered on init.
+
+        Args:
+            name: State name.
+
+        Returns:
+            None
+        """
+        self.initial_state = name
+
+    def get_parameter_index(self, name: str) -> int:
+        """Look up a parameter index by name.
+
+        Args:
+            name: Parameter name.
+
+        Returns:
+            The parameter index.
+        """
+        return self.parameter_names.index(name)
+
+    def set_parameter(self, index: int, value: float) -> None:
+        """Set a parameter value by index.
+
+        Args:
+            index: Index returned by add_parameter or get_parameter_index.
+            value: New value. Booleans are stored as 1.0/0.0.
+
+        Returns:
+            None
+        """
+        self.values[index] = float(value)
+
+    def get_state_name(self) -> str:
+        """Get the name of the current state.
+
+        Returns:
+            The state name, or an empty string before init.
+        """
+        return self.state_names[self.state] if self.state >= 0 else ""
+
+    def init(self) -> None:
+        """Compile the declared states and transitions into index tables.
+
+        Returns:
+            None
+        """
+        state_index = {name: i for i, name in enumerate(self.state_names)}
+        param_index = {name: i for i, name in enumerate(self.parameter_names)}
+        self.animations = []
+        for animation_name in self.state_animations:
+            animation = self.controller.get_animation(animation_name)
+            if not animation:
+                raise RuntimeError(f"Animation not found for state: {animation_name}")
+            self.animations.append(animation)
+
+        self.transitions = [[] for _ in self.state_names]
+        self.any_transitions = []
+        for from_state, to_state, conditions, exit_time in self.transition_defs:
+            compiled = tuple((param_index[name], self._OPS[op], float(value)) for name, op, value in conditions)
+            transition = (state_index[to_state], compiled, exit_time)
+            if from_state == self.ANY_STATE:
+                self.any_transitions.append(transition)
+            else:
+                self.transitions[state_index[from_state]].append(transition)
+
+        self.state = -1
+        if self.initial_state:
+            self.enter_state(state_index[self.initial_state])
+
+    def update(self, delta_time: float) -> None:
+        """Take the first transition whose conditions hold.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        if self.state < 0:
+            return
+        for transition in self.any_transitions:
+            if transition[0] != self.state and self._can_take(transition):
+                self.enter_state(transition[0])
+                return
+        for transition in self.transitions[self.state]:
+            if self._can_take(transition):
+                self.enter_state(transition[0])
+                return
+
+    def enter_state(self, state: int) -> None:
+        """Switch to a state by index and play its animation.
+
+        Args:
+            state: State index.
+
+        Returns:
+            None
+        """
+        self.state = state
+        animation = self.animations[state]
+        if self.state_restarts[state]:
+            animation.stop()
+        self.controller.set_animation(animation)
+        animation.play()
+
+    def _can_take(self, transition: tuple) -> bool:
+        """Test a compiled transition against the current parameters.
+
+        Args:
+            transition: (target, conditions, exit_time) tuple.
+
+        Returns:
+            True if the transition should be taken.
+        """
+        _, conditions, exit_time = transition
+        if exit_time >= 0.0:
+            animation = self.animations[self.state]
+            if animation.frames and (animation.current_frame + 1) / len(animation.frames) < exit_time:
+                return False
+        values = self.values
+        for index, op, value in conditions:
+            current = values[index]
+            if op == 0:
+                ok = current > value
+            elif op == 1:
+                ok = current >= value
+            elif op == 2:
+                ok = current < value
+            elif op == 3:
+                ok = current <= value
+            elif op == 4:
+                ok = current == value
+            else:
+                ok = current != value
+            if not ok:
+                return False
+        return True
+
+
 class PlatformerMovementParams:
     """Parameter bag for platformer movement."""
     def __init__(self) -> None:
@@ -944,10 +1739,18 @@ class PlatformerMovementParams:
         self.jump_cutoff_multiplier = 0.45
         self.coyote_time = 0.08
         self.jump_buffer = 0.10
+        # Used by KinematicPlatformerMovementComponent only.
+        self.step_height = 6.0
+        self.max_slope = 50.0
+        self.ground_snap = 4.0
 
 
 class PlatformerMovementComponent(Component):
-    """Component for 2D platformer movement."""
+    """Component for 2D platformer movement. Depends on PhysicsService and TimerService.
+
+    Coyote time and jump buffering are deadlines on the TimerService clock
+    (coyote_until, jump_buffer_until), so nothing counts down while idle.
+    """
     def __init__(self, params: PlatformerMovementParams) -> None:
         """  init  .
         
@@ -964,14 +1767,16 @@ class PlatformerMovementComponent(Component):
         self.grounded = False
         self.on_wall_left = False
         self.on_wall_right = False
-        self.coyote_timer = 0.0
-        self.jump_buffer_timer = 0.0
+        self.timers: Optional[TimerService] = None
+        self.coyote_until = 0.0
+        self.jump_buffer_until = 0.0
         self.move_x = 0.0
         self.jump_pressed = False
         self.jump_held = False
+        self.velocity = Vec2()
 
     def init(self) -> None:
-        """Resolve PhysicsService and BodyComponent.
+        """Resolve PhysicsService, TimerService, and BodyComponent.
 
         Returns:
             None
@@ -979,6 +1784,7 @@ class PlatformerMovementComponent(Component):
         if not self.owner or not self.owner.scene:
             return
         self.physics = self.owner.scene.get_service(PhysicsService)
+        self.timers = self.owner.scene.get_service(TimerService)
         self.body = self.owner.get_component(BodyComponent)
 
     def update(self, delta_time: float) -> None:
@@ -992,10 +1798,8 @@ class PlatformerMovementComponent(Component):
         """
         if not self.physics or not self.body or not self.body.body:
             return
-        self.coyote_timer = max(0.0, self.coyote_timer - delta_time)
-        self.jump_buffer_timer = max(0.0, self.jump_buffer_timer - delta_time)
         if self.jump_pressed:
-            self.jump_buffer_timer = self.p.jump_buffer
+            self.jump_buffer_until = self.timers.time + self.p.jump_buffer
 
         self.grounded = False
         self.on_wall_left = False
@@ -1026,30 +1830,45 @@ class PlatformerMovementComponent(Component):
         self.on_wall_right = right_wall_hit.hit
 
         if self.grounded:
-            self.coyote_timer = self.p.coyote_time
+            self.coyote_until = self.timers.time + self.p.coyote_time
 
-        target_vx = self.move_x * self.p.max_speed
-        v = self.body.get_velocity_pixels()
+        v = self.body.read_velocity_pixels(self.velocity)
+        v.x, v.y = self.compute_velocity(v.x, v.y, delta_time)
+        self.body.set_velocity(v)
+
+    def compute_velocity(self, vx: float, vy: float, delta_time: float) -> Tuple[float, float]:
+        """Apply input, gravity, and jumping to a velocity.
+
+        Uses the current grounded state and deadlines, and consumes a buffered jump.
+
+        Args:
+            vx: Horizontal velocity in pixels/sec.
+            vy: Vertical velocity in pixels/sec.
+            delta_time: Seconds since the last frame.
 
+        Returns:
+            The new (vx, vy) in pixels/sec.
+        """
+        target_vx = self.move_x * self.p.max_speed
         if abs(target_vx) > 0.001:
-            v.x = self.move_towards(v.x, target_vx, self.p.accel * delta_time)
+            vx = self.move_towards(vx, target_vx, self.p.accel * delta_time)
         else:
-            v.x = self.move_towards(v.x, 0.0, self.p.decel * delta_time)
+            vx = self.move_towards(vx, 0.0, self.p.decel * delta_time)
 
-        v.y += self.p.gravity * delta_time
-        v.y = max(-self.p.fall_speed, min(self.p.fall_speed, v.y))
+        vy += self.p.gravity * delta_time
+        vy = max(-self.p.fall_speed, min(self.p.fall_speed, vy))
 
-        can_jump = self.grounded or self.coyote_timer > 0.0
-        if self.jump_buffer_timer > 0.0 and can_jump:
-            v.y = -self.p.jump_speed
-            self.jump_buffer_timer = 0.0
-            self.coyote_timer = 0.0
+        now = self.timers.time
+        can_jump = self.grounded or now < self.coyote_until
+        if now < self.jump_buffer_until and can_jump:
+            vy = -self.p.jump_speed
+            self.jump_buffer_until = 0.0
+            self.coyote_until = 0.0
             self.grounded = False
 
-        if not self.jump_held and v.y < 0.0:
-            v.y *= self.p.jump_cutoff_multiplier
-
-        self.body.set_velocity(v)
+        if not self.jump_held and vy < 0.0:
+            vy *= self.p.jump_cutoff_multiplier
+        return vx, vy
 
     @staticmethod
     def move_towards(current: float, target: float, max_delta: float) -> float:
@@ -1084,6 +1903,177 @@ class PlatformerMovementComponent(Component):
         self.jump_held = jump_held
 
 
+class KinematicPlatformerMovementComponent(PlatformerMovementComponent):
+    """Platformer movement for a kinematic body using swept shape casts.
+
+    Instead of probing with raycasts and letting the solver resolve a dynamic
+    body, the character box is swept against static level geometry once per
+    axis per frame. Walkable slopes are followed, ledges up to step_height are
+    stepped over, and the character snaps down to ground within ground_snap
+    while walking. Grounded and wall state come from the sweep itself.
+
+    The body must be kinematic. The displacement is applied as a velocity for
+    the next physics step so dynamic bodies are still pushed. PhysicsService
+    takes one fixed step per frame, so movement is integrated and swept over
+    that time_step rather than the frame delta, and the body ends the step
+    exactly at the swept position. Keep the tick interval at 1: the velocity
+    would otherwise carry the body on, unswept, through the skipped frames. Box2D does not
+    generate contacts between kinematic and static or kinematic bodies, so
+    static or kinematic sensors will not see this character.
+    """
+    def __init__(self, params: PlatformerMovementParams) -> None:
+        """Create the controller.
+
+        Args:
+            params: Movement parameters, including step_height, max_slope, and ground_snap.
+
+        Returns:
+            None
+        """
+        super().__init__(params)
+        self.velocity_x = 0.0
+        self.velocity_y = 0.0
+        self.shape: Optional[b2PolygonShape] = None
+
+    def init(self) -> None:
+        """Resolve services and build the sweep shape.
+
+        Returns:
+            None
+        """
+        super().init()
+        if not self.physics:
+            return
+        self.shape = b2PolygonShape(box=(self.physics.convert_length_to_meters(self.p.width / 2.0),
+                                         self.physics.convert_length_to_meters(self.p.height / 2.0)))
+
+    def update(self, delta_time: float) -> None:
+        """Update movement, sweep the body, and set the velocity for the next step.
+
+        Args:
+            delta_time: Seconds since the last frame (the physics time_step is used instead).
+
+        Returns:
+            None
+        """
+        if not self.physics or not self.body or not self.body.body or not self.shape:
+            return
+        if self.jump_pressed:
+            self.jump_buffer_until = self.timers.time + self.p.jump_buffer
+        if self.grounded:
+            self.coyote_until = self.timers.time + self.p.coyote_time
+
+        time_step = self.physics.time_step
+        was_grounded = self.grounded
+        self.velocity_x, self.velocity_y = self.compute_velocity(self.velocity_x, self.velocity_y, time_step)
+        snap = was_grounded and self.grounded and self.velocity_y >= 0.0
+
+        start = self.body.get_position_meters()
+        position = self.move(b2Vec2(start.x, start.y), time_step, was_grounded, snap)
+        self.body.body.linearVelocity = b2Vec2((position.x - start.x) / time_step, (position.y - start.y) / time_step)
+
+    def move(self, position: b2Vec2, delta_time: float, was_grounded: bool, snap: bool) -> b2Vec2:
+        """Sweep the box by the current velocity, horizontal then vertical.
+
+        Args:
+            position: Start position in meters.
+            delta_time: Seconds to move over (the physics time_step).
+            was_grounded: True if the character started the frame on the ground.
+            snap: True to snap down to nearby ground if the sweep leaves it.
+
+        Returns:
+            The end position in meters.
+        """
+        self.grounded = False
+        self.on_wall_left = False
+        self.on_wall_right = False
+        min_ground_normal = math.cos(math.radians(self.p.max_slope))
+
+        dx = self.physics.convert_length_to_meters(self.velocity_x * delta_time)
+        if abs(dx) > 1e-9:
+            position = self._move_horizontal(position, dx, was_grounded, min_ground_normal)
+
+        dy = self.physics.convert_length_to_meters(self.velocity_y * delta_time)
+        if abs(dy) > 1e-9:
+            hit = self.cast(position, 0.0, dy)
+            position = b2Vec2(position.x, position.y + dy * hit.fraction)
+            if hit.hit:
+                if dy > 0.0 and -hit.normal.y >= min_ground_normal:
+                    self.grounded = True
+                    self.velocity_y = 0.0
+                elif dy < 0.0 and hit.normal.y > 0.0:
+                    self.velocity_y = 0.0
+
+        if not self.grounded and snap:
+            snap_distance = self.physics.convert_length_to_meters(self.p.ground_snap)
+            hit = self.cast(position, 0.0, snap_distance)
+            if hit.hit and -hit.normal.y >= min_ground_normal:
+                position = b2Vec2(position.x, position.y + snap_distance * hit.fraction)
+                self.grounded = True
+                self.velocity_y = 0.0
+        return position
+
+    def _move_horizontal(self, position: b2Vec2, dx: float, was_grounded: bool, min_ground_normal: float) -> b2Vec2:
+        """Sweep horizontally, following slopes and stepping up small ledges.
+
+        Args:
+            position: Start position in meters.
+            dx: Horizontal displacement in meters.
+            was_grounded: True if stepping up is allowed.
+            min_ground_normal: Minimum upward normal component of walkable ground.
+
+        Returns:
+            The end position in meters.
+        """
+        hit = self.cast(position, dx, 0.0)
+        if not hit.hit:
+            return b2Vec2(position.x + dx, position.y)
+        position = b2Vec2(position.x + dx * hit.fraction, position.y)
+        remaining = dx * (1.0 - hit.fraction)
+        normal = hit.normal
+
+        if -normal.y >= min_ground_normal:
+            # Walkable slope: spend the rest of the move along the surface.
+            tangent_x, tangent_y = -normal.y, normal.x
+            if tangent_x * remaining < 0.0:
+                tangent_x, tangent_y = -tangent_x, -tangent_y
+            slide_x, slide_y = tangent_x * abs(remaining), tangent_y * abs(remaining)
+            slide = self.cast(position, slide_x, slide_y)
+            return b2Vec2(position.x + slide_x * slide.fraction, position.y + slide_y * slide.fraction)
+
+        if was_grounded and self.p.step_height > 0.0:
+            step = self.physics.convert_length_to_meters(self.p.step_height)
+            up = self.cast(position, 0.0, -step)
+            rise = step * up.fraction
+            raised = b2Vec2(position.x, position.y - rise)
+            across = self.cast(raised, remaining, 0.0)
+            if across.fraction > 0.0:
+                stepped = b2Vec2(raised.x + remaining * across.fraction, raised.y)
+                down = self.cast(stepped, 0.0, rise)
+                if down.hit and -down.normal.y >= min_ground_normal:
+                    return b2Vec2(stepped.x, stepped.y + rise * down.fraction)
+
+        if dx < 0.0:
+            self.on_wall_left = True
+        else:
+            self.on_wall_right = True
+        self.velocity_x = 0.0
+        return position
+
+    def cast(self, position: b2Vec2, dx: float, dy: float) -> ShapeHit:
+        """Sweep the character box against static geometry.
+
+        Args:
+            position: Start position in meters.
+            dx: Horizontal displacement in meters.
+            dy: Vertical displacement in meters.
+
+        Returns:
+            ShapeHit for the first blocking surface.
+        """
+        return shape_cast(self.physics.world, self.body.body, self.shape, position, b2Vec2(dx, dy))
+
+
 class TopDownMovementParams:
     """Parameter bag for top-down movement."""
     def __init__(self) -> None:
@@ -1116,6 +2106,7 @@ class TopDownMovementComponent(Component):
         self.move_x = 0.0
         self.move_y = 0.0
         self.facing_dir = 0.0
+        self.velocity = Vec2()
 
     def init(self) -> None:
         """Resolve PhysicsService and BodyComponent.
@@ -1139,26 +2130,17 @@ class TopDownMovementComponent(Component):
         """
         if not self.body or not self.body.body:
             return
-        v = self.body.get_velocity_pixels()
-        input_vec = v2(self.move_x, self.move_y)
-        input_len_sq = input_vec.x * input_vec.x + input_vec.y * input_vec.y
-        desired = v2(0.0, 0.0)
-
-        if input_len_sq > self.p.deadzone * self.p.deadzone:
-            desired = v2(input_vec.x * self.p.max_speed, input_vec.y * self.p.max_speed)
-            self.facing_dir = math.degrees(math.atan2(input_vec.y, input_vec.x))
-            v = self.move_towards_vec(v, desired, self.p.accel * delta_time)
-        else:
-            v = self.apply_friction(v, self.p.friction * delta_time)
+        v = self.body.read_velocity_pixels(self.velocity)
+        move_x = self.move_x
+        move_y = self.move_y
 
-        speed_sq = v.x * v.x + v.y * v.y
-        max_speed_sq = self.p.max_speed * self.p.max_speed
-        if speed_sq > max_speed_sq:
-            speed = math.sqrt(speed_sq)
-            scale = self.p.max_speed / speed
-            v.x *= scale
-            v.y *= scale
+        if move_x * move_x + move_y * move_y > self.p.deadzone * self.p.deadzone:
+            self.facing_dir = math.degrees(math.atan2(move_y, move_x))
+            v.move_towards_ip(move_x * self.p.max_speed, move_y * self.p.max_speed, self.p.accel * delta_time)
+        else:
+            v.shrink_ip(self.p.friction * delta_time)
 
+        v.clamp_length_ip(self.p.max_speed)
         self.body.set_velocity(v)
 
     @staticmethod
@@ -1212,3 +2194,65 @@ class TopDownMovementComponent(Component):
         """
         self.move_x = horizontal
         self.move_y = vertical
+
+
+class CrowdAgentComponent(Component):
+    """Top-down movement driven by CrowdService instead of per-object input.
+
+    Registers the owner's body as a crowd agent. The service steers it toward
+    the closest crowd target while keeping it apart from other agents, using the
+    acceleration, friction, and max speed from the movement params.
+
+    slot is stored in the archetype column, so systems can gather crowd data
+    for a whole chunk of agents at once.
+    """
+    slot = EcsField(np.int64, -1)
+
+    def __init__(self, params: TopDownMovementParams) -> None:
+        """Store movement params.
+
+        Args:
+            params: Movement parameters. deadzone is taken from the service.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.p = params
+        self.crowd: Optional[CrowdService] = None
+        self.body: Optional[BodyComponent] = None
+        self.slot = -1
+
+    def init(self) -> None:
+        """Resolve CrowdService and register the owner's body.
+
+        Returns:
+            None
+        """
+        if not self.owner or not self.owner.scene:
+            return
+        self.crowd = self.owner.scene.get_service(CrowdService)
+        self.body = self.owner.get_component(BodyComponent)
+        if self.body and self.body.body:
+            self.slot = self.crowd.add_agent(self.body.body, self.p.max_speed, self.p.accel, self.p.friction)
+
+    def unload(self) -> None:
+        """Release the agent slot so the service stops steering the body.
+
+        Returns:
+            None
+        """
+        if self.crowd and self.slot >= 0:
+            self.crowd.remove_agent(self.slot)
+            self.slot = -1
+
+    @property
+    def facing_dir(self) -> float:
+        """Facing angle in degrees, from the last steering direction.
+
+        Returns:
+            Angle in degrees.
+        """
+        if not self.crowd or self.slot < 0:
+            return 0.0
+        return float(self.crowd.facing[self.slot])
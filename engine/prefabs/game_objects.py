@@ -7,9 +7,12 @@ from typing import Optional
 from Box2D import b2PolygonShape, b2Vec2
 import pyray as rl
 
+from engine import render
 from engine.framework import GameObject
 from engine.math_extensions import v2, vec_sub
-from engine.prefabs.components import BodyComponent, PlatformerMovementComponent, PlatformerMovementParams, SpriteComponent
+from engine.prefabs.components import (BodyComponent, KinematicPlatformerMovementComponent, PlatformerMovementComponent,
+                                       PlatformerMovementParams, SpriteComponent)
+from engine.prefabs.managers import InputManager, PlayerInput
 from engine.prefabs.services import PhysicsService
 
 
@@ -71,7 +74,7 @@ class StaticBox(GameObject):
             None
         """
         if self.is_visible:
-            rl.draw_rectangle(int(self.x - self.width / 2.0), int(self.y - self.height / 2.0), int(self.width), int(self.height), rl.Color(0, 121, 241, 255))
+            render.draw_rectangle(int(self.x - self.width / 2.0), int(self.y - self.height / 2.0), int(self.width), int(self.height), rl.Color(0, 121, 241, 255))
 
 
 class DynamicBox(GameObject):
@@ -141,12 +144,12 @@ class DynamicBox(GameObject):
             return
         pos = self.body.position
         angle = math.degrees(self.body.angle)
-        rl.draw_rectangle_pro(rl.Rectangle(self.physics.convert_length_to_pixels(pos.x),
-                                   self.physics.convert_length_to_pixels(pos.y),
-                                   self.width, self.height),
-                         v2(self.width / 2.0, self.height / 2.0),
-                         angle,
-                         rl.Color(230, 41, 55, 255))
+        render.draw_rectangle_pro(rl.Rectangle(self.physics.convert_length_to_pixels(pos.x),
+                                               self.physics.convert_length_to_pixels(pos.y),
+                                               self.width, self.height),
+                                  v2(self.width / 2.0, self.height / 2.0),
+                                  angle,
+                                  rl.Color(230, 41, 55, 255))
 
 
 class CameraObject(GameObject):
@@ -191,15 +194,17 @@ class CameraObject(GameObject):
         Returns:
             None
         """
-        desired = self.camera.target
+        # Each self.camera.target access wraps the cffi struct again, so fetch it once.
+        camera_target = self.camera.target
+        desired = camera_target
         inv_zoom = 1.0 / self.camera.zoom if self.camera.zoom != 0.0 else 1.0
         dz_left_w = self.offset_left * inv_zoom
         dz_right_w = self.offset_right * inv_zoom
         dz_top_w = self.offset_top * inv_zoom
         dz_bottom_w = self.offset_bottom * inv_zoom
 
-        dx = self.target.x - self.camera.target.x
-        dy = self.target.y - self.camera.target.y
+        dx = self.target.x - camera_target.x
+        dy = self.target.y - camera_target.y
 
         if dx < -dz_left_w:
             desired.x = self.target.x + dz_left_w
@@ -212,20 +217,21 @@ class CameraObject(GameObject):
             desired.y = self.target.y - dz_bottom_w
 
         if self.follow_speed.x < 0:
-            self.camera.target.x = desired.x
+            camera_target.x = desired.x
         else:
-            self.camera.target.x = self.move_towards(self.camera.target.x, desired.x, self.follow_speed.x * delta_time)
+            camera_target.x = self.move_towards(camera_target.x, desired.x, self.follow_speed.x * delta_time)
 
         if self.follow_speed.y < 0:
-            self.camera.target.y = desired.y
+            camera_target.y = desired.y
         else:
-            self.camera.target.y = self.move_towards(self.camera.target.y, desired.y, self.follow_speed.y * delta_time)
+            camera_target.y = self.move_towards(camera_target.y, desired.y, self.follow_speed.y * delta_time)
 
-        half_view = v2(self.size.x / 2.0 * inv_zoom, self.size.y / 2.0 * inv_zoom)
+        half_view_x = self.size.x / 2.0 * inv_zoom
+        half_view_y = self.size.y / 2.0 * inv_zoom
         if self.level_size.x > self.size.x:
-            self.camera.target.x = max(half_view.x, min(self.level_size.x - half_view.x, self.camera.target.x))
+            camera_target.x = max(half_view_x, min(self.level_size.x - half_view_x, camera_target.x))
         if self.level_size.y > self.size.y:
-            self.camera.target.y = max(half_view.y, min(self.level_size.y - half_view.y, self.camera.target.y))
+            camera_target.y = max(half_view_y, min(self.level_size.y - half_view_y, camera_target.y))
 
     @staticmethod
     def move_towards(current: float, target: float, max_delta: float) -> float:
@@ -285,7 +291,8 @@ class CameraObject(GameObject):
         Returns:
             None
         """
-        rl.begin_mode_2d(self.camera)
+        render.stats.begin_camera(self)
+        render.begin_mode_2d(self.camera)
 
     def draw_end(self) -> None:
         """Draw end.
@@ -293,7 +300,8 @@ class CameraObject(GameObject):
         Returns:
             None
         """
-        rl.end_mode_2d()
+        render.end_mode_2d()
+        render.stats.end_camera()
 
     def draw_debug(self, color: rl.Color = rl.Color(0, 255, 0, 120)) -> None:
         """TODO"""
@@ -306,7 +314,7 @@ class CameraObject(GameObject):
                          self.camera.target.y - dz_top_w,
                          dz_left_w + dz_right_w,
                          dz_top_w + dz_bottom_w)
-        rl.draw_rectangle_lines_ex(rect, 2.0 * inv_zoom, color)
+        render.draw_rectangle_lines_ex(rect, 2.0 * inv_zoom, color)
 
     def screen_to_world(self, point: rl.Vector2) -> rl.Vector2:
         """Convert screen coordinates to world coordinates.
@@ -335,9 +343,20 @@ class SplitCamera(CameraObject):
         Returns:
             None
         """
-        self.renderer = rl.load_render_texture(int(self.size.x), int(self.size.y))
+        if not self.scene.game.headless:
+            self.renderer = rl.load_render_texture(int(self.size.x), int(self.size.y))
         super().init()
 
+    def unload(self) -> None:
+        """Unload the render texture.
+
+        Returns:
+            None
+        """
+        if self.renderer:
+            rl.unload_render_texture(self.renderer)
+            self.renderer = None
+
     def draw_begin(self) -> None:
         """Draw begin.
         
@@ -346,9 +365,10 @@ class SplitCamera(CameraObject):
         """
         if not self.renderer:
             return
-        rl.begin_texture_mode(self.renderer)
+        render.stats.begin_camera(self)
+        render.begin_texture_mode(self.renderer)
         rl.clear_background(rl.WHITE)
-        rl.begin_mode_2d(self.camera)
+        render.begin_mode_2d(self.camera)
 
     def draw_end(self) -> None:
         """Draw end.
@@ -356,8 +376,9 @@ class SplitCamera(CameraObject):
         Returns:
             None
         """
-        rl.end_mode_2d()
-        rl.end_texture_mode()
+        render.end_mode_2d()
+        render.end_texture_mode()
+        render.stats.end_camera()
 
     def draw_texture(self, x: float, y: float) -> None:
         """Draw texture.
@@ -371,12 +392,12 @@ class SplitCamera(CameraObject):
         """
         if not self.renderer:
             return
-        rl.draw_texture_pro(self.renderer.texture,
-                       rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
-                       rl.Rectangle(x, y, float(self.renderer.texture.width), float(self.renderer.texture.height)),
-                       v2(0.0, 0.0),
-                       0.0,
-                       rl.WHITE)
+        render.draw_texture_pro(self.renderer.texture,
+                                rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
+                                rl.Rectangle(x, y, float(self.renderer.texture.width), float(self.renderer.texture.height)),
+                                v2(0.0, 0.0),
+                                0.0,
+                                rl.WHITE)
 
     def draw_texture_pro(self, x: float, y: float, width: float, height: float) -> None:
         """Draw texture pro.
@@ -392,12 +413,12 @@ class SplitCamera(CameraObject):
         """
         if not self.renderer:
             return
-        rl.draw_texture_pro(self.renderer.texture,
-                       rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
-                       rl.Rectangle(x, y, width, height),
-                       v2(0.0, 0.0),
-                       0.0,
-                       rl.WHITE)
+        render.draw_texture_pro(self.renderer.texture,
+                                rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
+                                rl.Rectangle(x, y, width, height),
+                                v2(0.0, 0.0),
+                                0.0,
+                                rl.WHITE)
 
     def screen_to_world_with_offset(self, draw_position: rl.Vector2, point: rl.Vector2) -> rl.Vector2:
         """Convert screen coordinates to world coordinates.
@@ -422,10 +443,11 @@ class CharacterParams:
     friction: float = 0.0
     restitution: float = 0.0
     density: float = 1.0
+    kinematic: bool = False
 
 
 class PlatformerCharacter(GameObject):
-    """Simple platformer character with movement."""
+    """Simple platformer character with movement. The scene needs PhysicsService and TimerService."""
     def __init__(self, params: CharacterParams, gamepad: int = 0) -> None:
         """  init  .
         
@@ -442,6 +464,7 @@ class PlatformerCharacter(GameObject):
         self.body: Optional[BodyComponent] = None
         self.movement: Optional[PlatformerMovementComponent] = None
         self.gamepad = gamepad
+        self.input: Optional[PlayerInput] = None
 
     def init(self) -> None:
         """Initialize the object.
@@ -450,6 +473,7 @@ class PlatformerCharacter(GameObject):
             None
         """
         self.physics = self.scene.get_service(PhysicsService)
+        self.input = self.scene.game.get_manager(InputManager).get_player(self.gamepad)
 
         def build_body(component: BodyComponent):
             """Build body.
@@ -461,9 +485,12 @@ class PlatformerCharacter(GameObject):
                 Result of the operation.
             """
             world = self.physics.world
-            body = world.CreateDynamicBody(position=(self.physics.convert_to_meters(self.p.position).x,
-                                                     self.physics.convert_to_meters(self.p.position).y),
-                                           fixedRotation=True)
+            position = (self.physics.convert_to_meters(self.p.position).x,
+                        self.physics.convert_to_meters(self.p.position).y)
+            if self.p.kinematic:
+                body = world.CreateKinematicBody(position=position, fixedRotation=True)
+            else:
+                body = world.CreateDynamicBody(position=position, fixedRotation=True)
             body.userData = self
             shape = b2PolygonShape(box=(self.physics.convert_length_to_meters(self.p.width / 2.0),
                                         self.physics.convert_length_to_meters(self.p.height / 2.0)))
@@ -474,7 +501,10 @@ class PlatformerCharacter(GameObject):
         params = PlatformerMovementParams()
         params.width = self.p.width
         params.height = self.p.height
-        self.movement = self.add_component(PlatformerMovementComponent(params))
+        if self.p.kinematic:
+            self.movement = self.add_component(KinematicPlatformerMovementComponent(params))
+        else:
+            self.movement = self.add_component(PlatformerMovementComponent(params))
 
     def update(self, delta_time: float) -> None:
 
@@ -486,17 +516,9 @@ class PlatformerCharacter(GameObject):
         Returns:
             None
         """
-        deadzone = 0.1
-        jump_pressed = rl.is_key_pressed(rl.KEY_W) or rl.is_gamepad_button_pressed(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-        jump_held = rl.is_key_down(rl.KEY_W) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-
-        move_x = rl.get_gamepad_axis_movement(self.gamepad, rl.GAMEPAD_AXIS_LEFT_X)
-        if abs(move_x) < deadzone:
-            move_x = 0.0
-        if rl.is_key_down(rl.KEY_D) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_RIGHT):
-            move_x = 1.0
-        elif rl.is_key_down(rl.KEY_A) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_LEFT):
-            move_x = -1.0
+        jump_pressed = self.input.pressed[InputManager.JUMP]
+        jump_held = self.input.down[InputManager.JUMP]
+        move_x = self.input.values[InputManager.MOVE_X]
 
         if self.movement:
             self.movement.set_input(move_x, jump_pressed, jump_held)
@@ -512,7 +534,7 @@ class PlatformerCharacter(GameObject):
             return
         color = rl.GREEN if self.movement.grounded else rl.BLUE
         pos = self.body.get_position_pixels()
-        rl.draw_rectangle_pro(rl.Rectangle(pos.x, pos.y, self.p.width, self.p.height),
-                         v2(self.p.width / 2.0, self.p.height / 2.0),
-                         0.0,
-                         color)
+        render.draw_rectangle_pro(rl.Rectangle(pos.x, pos.y, self.p.width, self.p.height),
+                                  v2(self.p.width / 2.0, self.p.height / 2.0),
+                                  0.0,
+                                  color)
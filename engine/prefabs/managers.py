@@ -1,9 +1,20 @@
 from __future__ import annotations
 
-from typing import Any, Dict, Optional, Type
+import gc
+import heapq
+import os
+import sys
+import time
+import traceback
+from collections import deque
+from concurrent.futures import Future, ThreadPoolExecutor
+from dataclasses import dataclass
+from typing import Any, Callable, Deque, Dict, Generator, List, Optional, Tuple, Type
 import pyray as rl
 
+from engine import render
 from engine.framework import Manager
+from engine.replay import InputRecorder, InputReplay, quantize, quantize_delta_time
 
 
 class MultiManager(Manager):
@@ -19,9 +30,61 @@ class MultiManager(Manager):
             None
         """
         for manager in self.managers.values():
+            manager.game = self.game
             manager.init_manager()
         super().init()
 
+    def begin_frame(self) -> None:
+        """Forward begin_frame to all contained managers.
+
+        Returns:
+            None
+        """
+        for manager in self.managers.values():
+            manager.begin_frame()
+
+    def update(self, delta_time: float) -> None:
+        """Forward update to all contained managers.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        for manager in self.managers.values():
+            manager.update(delta_time)
+
+    def draw(self) -> None:
+        """Forward draw to all contained managers.
+
+        Returns:
+            None
+        """
+        for manager in self.managers.values():
+            manager.draw()
+
+    def end_frame(self) -> None:
+        """Forward end_frame to all contained managers.
+
+        Returns:
+            None
+        """
+        for manager in self.managers.values():
+            manager.end_frame()
+
+    def on_scene_init(self, scene) -> None:
+        """Forward on_scene_init to all contained managers.
+
+        Args:
+            scene: The scene that was initialized.
+
+        Returns:
+            None
+        """
+        for manager in self.managers.values():
+            manager.on_scene_init(scene)
+
     def add_manager(self, name: str, manager_or_cls: Any, *args: Any, **kwargs: Any) -> Manager:
         """Add a manager instance or construct one from a class.
 
@@ -38,6 +101,7 @@ class MultiManager(Manager):
             manager = manager_or_cls
         else:
             manager = manager_or_cls(*args, **kwargs)
+        manager.game = self.game
         self.managers[name] = manager
         return manager
 
@@ -112,11 +176,14 @@ class WindowManager(Manager):
         self.target_fps = fps
 
     def init(self) -> None:
-        """Initialize the window and audio device.
+        """Initialize the window and audio device (skipped in a headless game).
 
         Returns:
             None
         """
+        if self.game and self.game.headless:
+            super().init()
+            return
         rl.set_config_flags(rl.FLAG_WINDOW_RESIZABLE)
         rl.init_window(self.width, self.height, self.title)
         rl.init_audio_device()
@@ -172,3 +239,1027 @@ class WindowManager(Manager):
             Width divided by height.
         """
         return float(self.width) / float(self.height)
+
+
+@dataclass
+class GcFrameStats:
+    """Garbage collector telemetry for one frame.
+
+    Attributes:
+        allocations: Net container allocations (allocations minus deallocations) tracked by the GC.
+        collections: Collections run during the frame, per generation.
+        collected: Objects freed by those collections.
+        gc_ms: Milliseconds spent collecting, automatic and scheduled.
+        scheduled_ms: Milliseconds of that spent in scheduled collections after end_drawing.
+        frame_ms: Wall time of the frame including scheduled collections.
+    """
+    allocations: int = 0
+    collections: tuple = (0, 0, 0)
+    collected: int = 0
+    gc_ms: float = 0.0
+    scheduled_ms: float = 0.0
+    frame_ms: float = 0.0
+
+
+class GcManager(Manager):
+    """Manager that schedules Python's cyclic garbage collector around frames.
+
+    - After each scene init, objects created so far are frozen (gc.freeze) so
+      collections no longer walk the level, bodies, and textures every time.
+    - Automatic gen-2 collection is turned off during gameplay by raising its
+      threshold; gen-0/1 still run automatically since they are short.
+    - After rl.end_drawing, young generations are collected while the frame
+      budget allows, and a full collection is run when one is due and its
+      measured cost fits, or when max_full_interval has passed.
+    - Per-frame allocation and collection telemetry is kept for the last
+      history_size frames.
+    """
+    def __init__(self,
+                 budget_ms: float = 2.0,
+                 max_full_interval: float = 10.0,
+                 freeze_after_scene_init: bool = True,
+                 history_size: int = 600) -> None:
+        """Configure the collection policy.
+
+        Args:
+            budget_ms: Milliseconds per frame that scheduled collections may use.
+            max_full_interval: Seconds after which a due full collection runs even if over budget.
+            freeze_after_scene_init: True to gc.freeze() after every scene init.
+            history_size: Frames of telemetry to keep.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.budget_ms = budget_ms
+        self.max_full_interval = max_full_interval
+        self.freeze_after_scene_init = freeze_after_scene_init
+        self.history: Deque[GcFrameStats] = deque(maxlen=history_size)
+        self.default_threshold = gc.get_threshold()
+        self.gen2_due = max(1, self.default_threshold[2])
+        self.collection_ms = [0.05, 0.5, 5.0]
+        self.last_full_time = time.perf_counter()
+        self.frame_start = 0.0
+        self.in_frame = False
+        self.scheduled = False
+        self.current = GcFrameStats()
+        self.collections: List[int] = [0, 0, 0]
+        self.allocation_base = 0
+        self.collection_start = 0.0
+
+    def init(self) -> None:
+        """Install the GC callback and disable automatic gen-2 collection.
+
+        Returns:
+            None
+        """
+        gc.callbacks.append(self._on_gc)
+        threshold0, threshold1, _ = self.default_threshold
+        gc.set_threshold(threshold0, threshold1, 1_000_000)
+        super().init()
+
+    def _on_gc(self, phase: str, info: Dict[str, int]) -> None:
+        """Record a collection, automatic or scheduled.
+
+        Args:
+            phase: "start" or "stop".
+            info: Collection info from the gc module.
+
+        Returns:
+            None
+        """
+        if phase == "start":
+            self.current.allocations += gc.get_count()[0] - self.allocation_base
+            self.collection_start = time.perf_counter()
+            return
+        elapsed = (time.perf_counter() - self.collection_start) * 1000.0
+        generation = info["generation"]
+        self.allocation_base = 0
+        if not self.in_frame and not self.scheduled:
+            return
+        self.collections[generation] += 1
+        self.current.collected += info["collected"]
+        self.current.gc_ms += elapsed
+        if self.scheduled:
+            self.current.scheduled_ms += elapsed
+        # Smoothed cost per generation, used to decide what fits in the budget.
+        self.collection_ms[generation] = self.collection_ms[generation] * 0.8 + elapsed * 0.2
+
+    def begin_frame(self) -> None:
+        """Start recording telemetry for a frame.
+
+        Returns:
+            None
+        """
+        self.current = GcFrameStats()
+        self.collections = [0, 0, 0]
+        self.allocation_base = gc.get_count()[0]
+        self.frame_start = time.perf_counter()
+        self.in_frame = True
+
+    def end_frame(self) -> None:
+        """Run scheduled collections within the budget and store the frame's telemetry.
+
+        Returns:
+            None
+        """
+        self.current.allocations += gc.get_count()[0] - self.allocation_base
+        self.allocation_base = gc.get_count()[0]
+        self.scheduled = True
+        start = time.perf_counter()
+        deadline = start + self.budget_ms / 1000.0
+        full_due = gc.get_count()[2] >= self.gen2_due
+        overdue = start - self.last_full_time >= self.max_full_interval
+        if full_due and (overdue or start + self.collection_ms[2] / 1000.0 <= deadline):
+            gc.collect(2)
+            self.last_full_time = time.perf_counter()
+        elif gc.get_count()[1] > 0 and start + self.collection_ms[1] / 1000.0 <= deadline:
+            gc.collect(1)
+        elif gc.get_count()[0] > 0 and start + self.collection_ms[0] / 1000.0 <= deadline:
+            gc.collect(0)
+        self.scheduled = False
+        self.in_frame = False
+
+        self.current.collections = tuple(self.collections)
+        self.current.frame_ms = (time.perf_counter() - self.frame_start) * 1000.0
+        self.history.append(self.current)
+
+    def on_scene_init(self, scene) -> None:
+        """Collect the previous scene's garbage and freeze everything the new scene created.
+
+        Args:
+            scene: The scene that was initialized.
+
+        Returns:
+            None
+        """
+        if not self.freeze_after_scene_init:
+            return
+        gc.unfreeze()
+        gc.collect()
+        gc.freeze()
+        self.last_full_time = time.perf_counter()
+
+    def get_summary(self) -> Dict[str, float]:
+        """Summarize recorded telemetry.
+
+        Returns:
+            Averages and maxima over the recorded frames.
+        """
+        if not self.history:
+            return {}
+        frames = len(self.history)
+        return {
+            "frames": frames,
+            "allocations_per_frame": sum(f.allocations for f in self.history) / frames,
+            "gc_ms_per_frame": sum(f.gc_ms for f in self.history) / frames,
+            "max_gc_ms": max(f.gc_ms for f in self.history),
+            "full_collections": sum(f.collections[2] for f in self.history),
+            "frozen_objects": gc.get_freeze_count(),
+        }
+
+
+class ProfilerManager(Manager):
+    """Manager that collects per-frame timings and counters, with an on-screen overlay.
+
+    Anything can report into the current frame with add_time and add_count;
+    frame_ms (begin_frame to end_frame) is recorded automatically. The last
+    history_size frames are kept. toggle_key shows the overlay with the last,
+    average, and maximum value of every entry.
+
+    While the overlay is visible, engine.render counts draws, and the frame's
+    draw calls, batch flushes, and texture, render target, and blend switches
+    are recorded too, with a breakdown per camera and for the owners with the
+    most draw calls.
+    """
+    def __init__(self, history_size: int = 300, toggle_key: int = rl.KEY_F3, font_size: int = 10,
+                 render_stats: bool = True, owner_rows: int = 6) -> None:
+        """Configure history and overlay.
+
+        Args:
+            history_size: Frames of values to keep.
+            toggle_key: Key that shows and hides the overlay.
+            font_size: Overlay text size.
+            render_stats: Count draws while the overlay is visible.
+            owner_rows: Owners listed in the draw call breakdown.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.render_stats = render_stats
+        self.owner_rows = owner_rows
+        self.history: Deque[Dict[str, float]] = deque(maxlen=history_size)
+        self.toggle_key = toggle_key
+        self.font_size = font_size
+        self.visible = False
+        self.current: Dict[str, float] = {}
+        self.frame_start = 0.0
+
+    def begin_frame(self) -> None:
+        """Start a new frame of values.
+
+        Returns:
+            None
+        """
+        self.current = {}
+        self.frame_start = time.perf_counter()
+
+    def add_time(self, name: str, ms: float) -> None:
+        """Add milliseconds to a timing of the current frame.
+
+        Args:
+            name: Timing name.
+            ms: Milliseconds to add.
+
+        Returns:
+            None
+        """
+        self.current[name] = self.current.get(name, 0.0) + ms
+
+    def add_count(self, name: str, value: float = 1.0) -> None:
+        """Add to a counter of the current frame.
+
+        Args:
+            name: Counter name.
+            value: Amount to add.
+
+        Returns:
+            None
+        """
+        self.current[name] = self.current.get(name, 0.0) + value
+
+    def update(self, delta_time: float) -> None:
+        """Toggle the overlay.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        if not self.game.headless and rl.is_key_pressed(self.toggle_key):
+            self.visible = not self.visible
+            if self.render_stats:
+                render.stats.enabled = self.visible
+
+    def draw(self) -> None:
+        """Draw the overlay in the top-left corner.
+
+        Returns:
+            None
+        """
+        if not self.visible or not self.history:
+            return
+        summary = self.get_summary()
+        lines = [f"{'':<16}{'last':>9}{'avg':>9}{'max':>9}"]
+        last = self.history[-1]
+        for name in sorted(summary["max"]):
+            lines.append(f"{name:<16}{last.get(name, 0.0):>9.2f}{summary['avg'][name]:>9.2f}"
+                         f"{summary['max'][name]:>9.2f}")
+        frame = render.stats.last
+        if render.stats.enabled and frame:
+            lines.append("")
+            lines.append(f"{'':<16}{'calls':>9}{'flushes':>9}{'textures':>9}")
+            owners = sorted((item for item in frame["owners"].items() if item[1]["draw_calls"]),
+                            key=lambda item: -item[1]["draw_calls"])
+            for name, counts in list(frame["cameras"].items()) + owners[:self.owner_rows]:
+                lines.append(f"{name[:15]:<16}{counts['draw_calls']:>9}{counts['batch_flushes']:>9}"
+                             f"{counts['texture_switches']:>9}")
+        line_height = self.font_size + 2
+        render.draw_rectangle(4, 4, self.font_size * 26, line_height * len(lines) + 8, rl.fade(rl.BLACK, 0.7))
+        for i, line in enumerate(lines):
+            render.draw_text(line, 8, 8 + i * line_height, self.font_size, rl.RAYWHITE)
+
+    def end_frame(self) -> None:
+        """Record frame_ms and store the frame's values.
+
+        Returns:
+            None
+        """
+        self.current["frame_ms"] = (time.perf_counter() - self.frame_start) * 1000.0
+        if render.stats.enabled and render.stats.last:
+            self.current.update(render.stats.last["totals"])
+        self.history.append(self.current)
+
+    def get_summary(self) -> Dict[str, Dict[str, float]]:
+        """Summarize recorded frames. Entries missing from a frame count as 0.
+
+        Returns:
+            {"avg": {name: value}, "max": {name: value}}.
+        """
+        frames = len(self.history)
+        names = set()
+        for values in self.history:
+            names.update(values)
+        average = {name: sum(values.get(name, 0.0) for values in self.history) / frames for name in names}
+        maximum = {name: max(values.get(name, 0.0) for values in self.history) for name in names}
+        return {"avg": average, "max": maximum}
+
+
+class Job:
+    """Resumable job queued on JobManager.
+
+    Attributes:
+        task: Generator advanced one step at a time; its return value is the result.
+        priority: Higher priorities run first; equal priorities run in submission order.
+        on_complete: Called with the result when the task finishes.
+        name: Label used in profiler output.
+        scene: Scene the job belongs to; it is cancelled when that scene is exited. None runs until done.
+        result: Value returned by the task once done.
+        error: Exception raised by the task, or None.
+        is_done: True once the task has finished, failed, or been cancelled.
+        is_cancelled: True if cancel() was called.
+    """
+    __slots__ = ("task", "priority", "on_complete", "name", "scene", "result", "error", "is_done", "is_cancelled")
+
+    def __init__(self, task: Generator[Any, None, Any], priority: int,
+                 on_complete: Optional[Callable[[Any], None]], name: str, scene: Any = None) -> None:
+        """Create the job. Use JobManager.submit rather than calling this directly.
+
+        Args:
+            task: Generator to advance.
+            priority: Higher priorities run first.
+            on_complete: Function called with the result, or None.
+            name: Label used in profiler output.
+            scene: Scene the job belongs to, or None.
+
+        Returns:
+            None
+        """
+        self.task = task
+        self.priority = priority
+        self.on_complete = on_complete
+        self.name = name
+        self.scene = scene
+        self.result: Any = None
+        self.error: Optional[BaseException] = None
+        self.is_done = False
+        self.is_cancelled = False
+
+    def cancel(self) -> None:
+        """Stop the job. Its generator is closed and on_complete is not called.
+
+        Returns:
+            None
+        """
+        if self.is_done:
+            return
+        self.is_cancelled = True
+        self.is_done = True
+        self.task.close()
+
+
+class JobManager(Manager):
+    """Manager that spreads long-running work over frames within a time budget.
+
+    Jobs are generators: each step runs until the next yield, so work split
+    into small steps (a row of tiles, a batch of nodes) never stalls a frame.
+    After the scene updates, steps are run from the highest-priority job until
+    budget_ms is used up. At least one step runs every frame so jobs always
+    progress; a step that pushes the frame past the budget is counted as an
+    overrun in ProfilerManager (job_overrun_ms, job_overruns).
+
+    A job submitted while a scene is current belongs to that scene and is
+    cancelled when the scene is exited, so it never runs against a scene
+    that is no longer updated. A job whose step or on_complete raises is
+    logged and dropped (error holds the exception); the other jobs go on.
+    """
+    def __init__(self, budget_ms: float = 2.0) -> None:
+        """Configure the budget.
+
+        Args:
+            budget_ms: Milliseconds per frame that job steps may use.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.budget_ms = budget_ms
+        self.queue: List[Tuple[int, int, Job]] = []
+        self.sequence = 0
+        self.profiler: Optional[ProfilerManager] = None
+
+    def init(self) -> None:
+        """Resolve ProfilerManager if the game has one.
+
+        Returns:
+            None
+        """
+        if self.game.has_manager(ProfilerManager):
+            self.profiler = self.game.get_manager(ProfilerManager)
+
+    def submit(self, task: Generator[Any, None, Any], priority: int = 0,
+               on_complete: Optional[Callable[[Any], None]] = None, name: str = "") -> Job:
+        """Queue a job.
+
+        Args:
+            task: Generator to advance; yield between small units of work and return the result.
+            priority: Higher priorities run first.
+            on_complete: Called with the task's return value when it finishes.
+            name: Label for the job.
+
+        Returns:
+            Job handle for cancel() and the result.
+        """
+        job = Job(task, priority, on_complete, name, self.game.current_scene if self.game else None)
+        heapq.heappush(self.queue, (-priority, self.sequence, job))
+        self.sequence += 1
+        return job
+
+    def cancel_all(self) -> None:
+        """Cancel every queued job.
+
+        Returns:
+            None
+        """
+        for _, _, job in self.queue:
+            job.cancel()
+        self.queue.clear()
+
+    def on_scene_exit(self, scene: Any) -> None:
+        """Cancel the jobs that belong to the exited scene.
+
+        Args:
+            scene: The scene that was exited.
+
+        Returns:
+            None
+        """
+        for _, _, job in self.queue:
+            if job.scene is scene:
+                job.cancel()
+        self.queue = [entry for entry in self.queue if not entry[2].is_done]
+        heapq.heapify(self.queue)
+
+    def get_pending_count(self) -> int:
+        """Count jobs that have not finished.
+
+        Returns:
+            Number of queued, uncancelled jobs.
+        """
+        return sum(1 for _, _, job in self.queue if not job.is_done)
+
+    def _fail(self, job: Job, error: Exception) -> None:
+        """Log a job's exception and mark the job done.
+
+        Args:
+            job: Job whose task or on_complete raised.
+            error: The exception.
+
+        Returns:
+            None
+        """
+        job.is_done = True
+        job.error = error
+        print(f"Job failed: {job.name or job.task}")
+        traceback.print_exception(type(error), error, error.__traceback__)
+
+    def update(self, delta_time: float) -> None:
+        """Run job steps until the frame's budget is used up.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        queue = self.queue
+        if not queue:
+            return
+        start = time.perf_counter()
+        deadline = start + self.budget_ms / 1000.0
+        steps = 0
+        now = start
+        while queue and (now < deadline or steps == 0):
+            job = queue[0][2]
+            if job.is_done:
+                heapq.heappop(queue)
+                continue
+            try:
+                next(job.task)
+            except StopIteration as stop:
+                heapq.heappop(queue)
+                job.is_done = True
+                job.result = stop.value
+                if job.on_complete:
+                    try:
+                        job.on_complete(stop.value)
+                    except Exception as error:
+                        self._fail(job, error)
+            except Exception as error:
+                heapq.heappop(queue)
+                self._fail(job, error)
+            steps += 1
+            now = time.perf_counter()
+
+        if self.profiler:
+            elapsed_ms = (now - start) * 1000.0
+            self.profiler.add_time("jobs_ms", elapsed_ms)
+            self.profiler.add_count("job_steps", steps)
+            if elapsed_ms > self.budget_ms:
+                self.profiler.add_time("job_overrun_ms", elapsed_ms - self.budget_ms)
+                self.profiler.add_count("job_overruns")
+
+
+class WorkerManager(Manager):
+    """Manager that runs CPU work on a thread pool.
+
+    Submitted functions must not call raylib or touch Box2D objects; the main
+    thread collects their results with wait(), after doing its own work in
+    the meantime. The pool is shut down with the game.
+
+    On free-threaded CPython builds Python code runs on all cores. On
+    standard builds the GIL lets only one thread run Python at a time, so
+    the pool pays off for work that releases it: NumPy kernels, zlib, file
+    reads, and raylib calls made through cffi.
+    """
+    def __init__(self, max_workers: Optional[int] = None) -> None:
+        """Configure the pool size.
+
+        Args:
+            max_workers: Worker threads (defaults to the CPU count).
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.max_workers = max_workers or os.cpu_count() or 1
+        self.executor: Optional[ThreadPoolExecutor] = None
+
+    def init(self) -> None:
+        """Start the worker threads.
+
+        Returns:
+            None
+        """
+        self.executor = ThreadPoolExecutor(self.max_workers, thread_name_prefix="worker")
+
+    def shutdown(self) -> None:
+        """Cancel queued work and join the worker threads.
+
+        Returns:
+            None
+        """
+        if self.executor:
+            self.executor.shutdown(wait=True, cancel_futures=True)
+            self.executor = None
+
+    def is_free_threaded(self) -> bool:
+        """Check whether Python code on workers can run in parallel.
+
+        Returns:
+            True on a free-threaded build with the GIL disabled.
+        """
+        is_gil_enabled = getattr(sys, "_is_gil_enabled", None)
+        return is_gil_enabled is not None and not is_gil_enabled()
+
+    def submit(self, fn: Callable[..., Any], *args: Any) -> Future:
+        """Run a function on a worker thread.
+
+        Args:
+            fn: Function to run. Must not call raylib or Box2D.
+            *args: Arguments for fn.
+
+        Returns:
+            Future for the result.
+        """
+        return self.executor.submit(fn, *args)
+
+    def map(self, fn: Callable[[Any], Any], items: List[Any]) -> List[Future]:
+        """Run a function on every item across the workers.
+
+        Args:
+            fn: Function of one item.
+            items: Items to process.
+
+        Returns:
+            One future per item, in order.
+        """
+        return [self.executor.submit(fn, item) for item in items]
+
+    def wait(self, futures: List[Future]) -> List[Any]:
+        """Block the main thread until every future is done.
+
+        Args:
+            futures: Futures returned by submit or map.
+
+        Returns:
+            Results in order. Exceptions raised on workers are re-raised here.
+        """
+        return [future.result() for future in futures]
+
+
+# Binding sources for InputManager.
+INPUT_KEY = 0
+INPUT_GAMEPAD_BUTTON = 1
+INPUT_GAMEPAD_AXIS = 2
+
+
+@dataclass
+class InputBinding:
+    """One device input mapped to an action.
+
+    Attributes:
+        source: INPUT_KEY, INPUT_GAMEPAD_BUTTON, or INPUT_GAMEPAD_AXIS.
+        code: Raylib key, gamepad button, or gamepad axis constant.
+        scale: Value contributed when active (e.g. -1.0 for "left"); multiplies axis values.
+    """
+    source: int
+    code: int
+    scale: float = 1.0
+
+
+class PlayerInput:
+    """Per-player action state for the current frame, indexed by action id.
+
+    Attributes:
+        values: Action values; -1..1 for axes, 0 or 1 for buttons.
+        down: True while the action is held.
+        pressed: True on the frame the action went down.
+        released: True on the frame the action went up.
+    """
+    __slots__ = ("values", "down", "pressed", "released")
+
+    def __init__(self, action_count: int) -> None:
+        self.values = [0.0] * action_count
+        self.down = [False] * action_count
+        self.pressed = [False] * action_count
+        self.released = [False] * action_count
+
+    def resize(self, action_count: int) -> None:
+        """Grow the state lists to hold action_count actions.
+
+        Args:
+            action_count: Number of actions.
+
+        Returns:
+            None
+        """
+        extra = action_count - len(self.values)
+        if extra > 0:
+            self.values.extend([0.0] * extra)
+            self.down.extend([False] * extra)
+            self.pressed.extend([False] * extra)
+            self.released.extend([False] * extra)
+
+
+class InputManager(Manager):
+    """Manager that polls input devices once per frame into per-player action state.
+
+    Actions are named and addressed by integer id. Each action has a list of
+    bindings; keyboard bindings apply to every player, gamepad bindings read the
+    player's own gamepad (player index == gamepad index). Every bound key, and
+    every bound button and axis of each connected gamepad, is read exactly once
+    per frame in begin_frame, so gameplay code reads plain Python lists instead
+    of calling into raylib.
+
+    An action's value is the sum of its active key/button bindings (clamped to
+    -1..1). If none is active, the value comes from its axis bindings, after the
+    action's deadzone. An action is down when its value reaches press_threshold.
+
+    Sessions can be recorded to a binary log (start_recording) and played back
+    (start_replay). Both go through next_delta_time, which the main loop calls
+    once per frame to get the delta time to pass to Game.update.
+
+    Attributes:
+        players: PlayerInput per player.
+        source: If set, called every frame instead of polling devices; returns
+            action values per player (scripted input for batch simulation).
+        polled: Action values per player read by the last begin_frame.
+        apply_polled: True to apply polled values to players in begin_frame. A
+            rollback session turns it off and applies the inputs of each
+            simulated frame itself, so pressed/released edges are measured
+            between simulated frames rather than against the live devices.
+    """
+    MOVE_X = 0
+    MOVE_Y = 1
+    JUMP = 2
+    ATTACK = 3
+    DOWN = 4
+    START = 5
+    STICK_Y = 6
+
+    def __init__(self, player_count: int = 4, default_bindings: bool = True) -> None:
+        """Create the manager.
+
+        Args:
+            player_count: Number of players (and gamepads) to track.
+            default_bindings: True to add the actions and bindings the samples use.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.player_count = player_count
+        self.action_names: List[str] = []
+        self.action_ids: Dict[str, int] = {}
+        self.bindings: List[List[InputBinding]] = []
+        self.deadzones: List[float] = []
+        self.press_threshold = 0.5
+        self.players = [PlayerInput(0) for _ in range(player_count)]
+        self.keys: List[int] = []
+        self.buttons: List[int] = []
+        self.axes: List[int] = []
+        self.recorder: Optional[InputRecorder] = None
+        self.replay: Optional[InputReplay] = None
+        self.replay_frame: List[List[float]] = []
+        self.delta_time = 0.0
+        self.source: Optional[Callable[[], List[List[float]]]] = None
+        self.polled: List[List[float]] = [[] for _ in range(player_count)]
+        self.apply_polled = True
+        if default_bindings:
+            self.add_default_bindings()
+
+    def add_default_bindings(self) -> None:
+        """Add the default actions (ids match the class constants) and bindings.
+
+        Returns:
+            None
+        """
+        self.add_action("move_x", deadzone=0.1)
+        self.add_action("move_y", deadzone=0.1)
+        self.add_action("jump")
+        self.add_action("attack")
+        self.add_action("down")
+        self.add_action("start")
+        self.add_action("stick_y", deadzone=0.1)
+
+        self.bind("move_x", INPUT_KEY, rl.KEY_A, -1.0)
+        self.bind("move_x", INPUT_KEY, rl.KEY_D, 1.0)
+        self.bind("move_x", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_LEFT_FACE_LEFT, -1.0)
+        self.bind("move_x", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_LEFT_FACE_RIGHT, 1.0)
+        self.bind("move_x", INPUT_GAMEPAD_AXIS, rl.GAMEPAD_AXIS_LEFT_X)
+
+        self.bind("move_y", INPUT_KEY, rl.KEY_W, -1.0)
+        self.bind("move_y", INPUT_KEY, rl.KEY_S, 1.0)
+        self.bind("move_y", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_LEFT_FACE_UP, -1.0)
+        self.bind("move_y", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_LEFT_FACE_DOWN, 1.0)
+        self.bind("move_y", INPUT_GAMEPAD_AXIS, rl.GAMEPAD_AXIS_LEFT_Y)
+
+        self.bind("jump", INPUT_KEY, rl.KEY_W)
+        self.bind("jump", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
+
+        self.bind("attack", INPUT_KEY, rl.KEY_SPACE)
+        self.bind("attack", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_RIGHT_FACE_RIGHT)
+
+        self.bind("down", INPUT_KEY, rl.KEY_S)
+        self.bind("down", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_LEFT_FACE_DOWN)
+
+        self.bind("start", INPUT_KEY, rl.KEY_ENTER)
+        self.bind("start", INPUT_GAMEPAD_BUTTON, rl.GAMEPAD_BUTTON_MIDDLE_RIGHT)
+
+        # Stick only, for code that treats a held stick differently from a pressed key.
+        self.bind("stick_y", INPUT_GAMEPAD_AXIS, rl.GAMEPAD_AXIS_LEFT_Y)
+
+    def add_action(self, name: str, deadzone: float = 0.0) -> int:
+        """Add a named action, or return the id of an existing one.
+
+        Args:
+            name: Action name.
+            deadzone: Axis values with a smaller magnitude read as 0.
+
+        Returns:
+            Action id, used to index PlayerInput lists.
+        """
+        if name in self.action_ids:
+            return self.action_ids[name]
+        action = len(self.action_names)
+        self.action_names.append(name)
+        self.action_ids[name] = action
+        self.bindings.append([])
+        self.deadzones.append(deadzone)
+        for player in self.players:
+            player.resize(len(self.action_names))
+        return action
+
+    def get_action(self, name: str) -> int:
+        """Get an action id by name.
+
+        Args:
+            name: Action name.
+
+        Returns:
+            Action id.
+
+        Raises:
+            RuntimeError: If no action has that name.
+        """
+        if name not in self.action_ids:
+            print(f"Input action not found: {name}")
+            raise RuntimeError(f"Input action not found: {name}")
+        return self.action_ids[name]
+
+    def bind(self, action: Any, source: int, code: int, scale: float = 1.0) -> None:
+        """Add a binding to an action.
+
+        Args:
+            action: Action name or id.
+            source: INPUT_KEY, INPUT_GAMEPAD_BUTTON, or INPUT_GAMEPAD_AXIS.
+            code: Raylib key, gamepad button, or gamepad axis constant.
+            scale: Value when active, or axis multiplier.
+
+        Returns:
+            None
+        """
+        action_id = self.get_action(action) if isinstance(action, str) else action
+        self.bindings[action_id].append(InputBinding(source, code, scale))
+        self._collect_inputs()
+
+    def clear_bindings(self, action: Any) -> None:
+        """Remove every binding from an action, so it can be rebound.
+
+        Args:
+            action: Action name or id.
+
+        Returns:
+            None
+        """
+        action_id = self.get_action(action) if isinstance(action, str) else action
+        self.bindings[action_id] = []
+        self._collect_inputs()
+
+    def _collect_inputs(self) -> None:
+        """Rebuild the lists of distinct keys, buttons, and axes to poll.
+
+        Returns:
+            None
+        """
+        keys, buttons, axes = set(), set(), set()
+        for bindings in self.bindings:
+            for binding in bindings:
+                if binding.source == INPUT_KEY:
+                    keys.add(binding.code)
+                elif binding.source == INPUT_GAMEPAD_BUTTON:
+                    buttons.add(binding.code)
+                else:
+                    axes.add(binding.code)
+        self.keys = sorted(keys)
+        self.buttons = sorted(buttons)
+        self.axes = sorted(axes)
+
+    def poll(self) -> List[List[float]]:
+        """Read every bound input once and compute action values.
+
+        Returns:
+            Action values per player.
+        """
+        key_down = {key: rl.is_key_down(key) for key in self.keys}
+        frame: List[List[float]] = []
+        for player in range(self.player_count):
+            if rl.is_gamepad_available(player):
+                button_down = {button: rl.is_gamepad_button_down(player, button) for button in self.buttons}
+                axis_value = {axis: rl.get_gamepad_axis_movement(player, axis) for axis in self.axes}
+            else:
+                button_down = {}
+                axis_value = {}
+            values = []
+            for action, bindings in enumerate(self.bindings):
+                digital = 0.0
+                analog = 0.0
+                active = False
+                for binding in bindings:
+                    if binding.source == INPUT_KEY:
+                        if key_down[binding.code]:
+                            digital += binding.scale
+                            active = True
+                    elif binding.source == INPUT_GAMEPAD_BUTTON:
+                        if button_down.get(binding.code, False):
+                            digital += binding.scale
+                            active = True
+                    else:
+                        value = axis_value.get(binding.code, 0.0) * binding.scale
+                        if abs(value) > abs(analog):
+                            analog = value
+                if active:
+                    values.append(max(-1.0, min(1.0, digital)))
+                elif abs(analog) < self.deadzones[action]:
+                    values.append(0.0)
+                else:
+                    values.append(analog)
+            frame.append(values)
+        return frame
+
+    def apply(self, frame: List[List[float]]) -> None:
+        """Set action values for a frame and update held and edge state.
+
+        Args:
+            frame: Action values per player, as returned by poll.
+
+        Returns:
+            None
+        """
+        threshold = self.press_threshold
+        for player, values in zip(self.players, frame):
+            player.values = values
+            down = player.down
+            pressed = player.pressed
+            released = player.released
+            for action, value in enumerate(values):
+                is_down = value >= threshold
+                was_down = down[action]
+                pressed[action] = is_down and not was_down
+                released[action] = was_down and not is_down
+                down[action] = is_down
+
+    def begin_frame(self) -> None:
+        """Poll devices (or read the replay) and update every player's state.
+
+        Returns:
+            None
+        """
+        if self.replay:
+            frame = self.replay_frame
+        else:
+            frame = self.source() if self.source else self.poll()
+            if self.recorder:
+                frame = quantize(frame)
+                self.recorder.write_frame(self.delta_time, frame)
+        self.polled = frame
+        if self.apply_polled:
+            self.apply(frame)
+
+    def start_recording(self, filename: str, seed: int) -> None:
+        """Record every following frame to a log.
+
+        Args:
+            filename: Output path.
+            seed: Random seed the session uses, stored in the log.
+
+        Returns:
+            None
+        """
+        self.stop()
+        self.recorder = InputRecorder(filename, self.player_count, len(self.action_names), seed)
+
+    def start_replay(self, filename: str) -> int:
+        """Feed every following frame from a log instead of the devices.
+
+        Args:
+            filename: Log path.
+
+        Returns:
+            The random seed the log was recorded with.
+
+        Raises:
+            ValueError: If the log was recorded with a different player or action count.
+        """
+        self.stop()
+        replay = InputReplay(filename)
+        if replay.player_count != self.player_count or replay.action_count != len(self.action_names):
+            raise ValueError(f"Input log {filename} has {replay.player_count} players and {replay.action_count} "
+                             f"actions, expected {self.player_count} and {len(self.action_names)}")
+        self.replay = replay
+        return replay.seed
+
+    def stop(self) -> None:
+        """Stop recording or replaying.
+
+        Returns:
+            None
+        """
+        if self.recorder:
+            self.recorder.close()
+            self.recorder = None
+        self.replay = None
+
+    def next_delta_time(self, delta_time: float) -> float:
+        """Get the delta time to simulate the next frame with.
+
+        When replaying, this reads the next frame from the log and returns its
+        recorded delta time. When recording, the delta time is rounded to the
+        precision stored in the log so the replay matches exactly.
+
+        Args:
+            delta_time: Delta time the main loop would use.
+
+        Returns:
+            Delta time to pass to Game.update.
+        """
+        if self.replay:
+            record = self.replay.read_frame()
+            if record is None:
+                return 0.0
+            self.delta_time, self.replay_frame = record
+            return self.delta_time
+        self.delta_time = quantize_delta_time(delta_time) if self.recorder else delta_time
+        return self.delta_time
+
+    def is_replay_finished(self) -> bool:
+        """Check whether a replay has run out of frames.
+
+        Returns:
+            True if replaying and the log is exhausted.
+        """
+        return bool(self.replay and self.replay.is_finished())
+
+    def get_player(self, index: int) -> PlayerInput:
+        """Get a player's input state.
+
+        Args:
+            index: Player index (also the gamepad index).
+
+        Returns:
+            The player's PlayerInput.
+        """
+        return self.players[index]
@@ -1,18 +1,28 @@
 from __future__ import annotations
 
+import bisect
+import heapq
 import json
 import math
+import random
+import zlib
+from operator import attrgetter
 from dataclasses import dataclass
-from typing import Any, Dict, List, Optional
+from typing import Any, Callable, Dict, Generator, List, Optional, Tuple
 
 from Box2D import (b2Body, b2CircleShape, b2EdgeShape, b2FixtureDef,
-                   b2PolygonShape, b2Vec2, b2World)
+                   b2PolygonShape, b2Vec2, b2World, b2_kinematicBody, b2_staticBody)
+import numpy as np
 import pyray as rl
 
+from engine import render
 from engine.framework import Service
-from engine.math_extensions import v2
-from engine.physics_debug import PhysicsDebugRenderer
+from engine.math_extensions import get_view_bounds, v2
+from engine.prefabs.managers import Job, JobManager, WorkerManager
+from engine.physics_debug import (ASLEEP_COLOR, AWAKE_COLOR, INACTIVE_COLOR, JOINT_COLOR, KINEMATIC_COLOR,
+                                  PhysicsDebugRenderer)
 from engine.raycasts import circle_hit, raycast_closest, rectangle_hit
+from engine.spatial_hash import SpatialHash
 from engine.LdtkJson import LdtkJSON, Level, LayerInstance, GridPoint
 
 
@@ -36,6 +46,15 @@ class MultiService(Service):
             service.init()
         super().init_service()
 
+    def unload(self) -> None:
+        """Unload all contained services.
+
+        Returns:
+            None
+        """
+        for service in self.services.values():
+            service.unload()
+
     def update(self, delta_time: float) -> None:
         """Update all contained services.
 
@@ -89,6 +108,280 @@ class MultiService(Service):
         return self.services.get(name)
 
 
+class RandomService(Service):
+    """Seeded random number generator for gameplay code.
+
+    Use this instead of rl.get_random_value, whose state is global and not
+    reproducible across runs. Unless a seed is given, the generator is seeded
+    from Game.seed when the scene initializes, so recorded sessions replay the
+    same sequence.
+    """
+    def __init__(self, seed: Optional[int] = None) -> None:
+        """Create the service.
+
+        Args:
+            seed: Fixed seed, or None to use Game.seed.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.seed = seed
+        self.random = random.Random(0)
+
+    def init(self) -> None:
+        """Seed the generator.
+
+        Returns:
+            None
+        """
+        self.random.seed(self.seed if self.seed is not None else self.scene.game.seed)
+
+    def get_value(self, min_value: int, max_value: int) -> int:
+        """Get a random integer, inclusive of both ends (like rl.get_random_value).
+
+        Args:
+            min_value: Smallest value.
+            max_value: Largest value.
+
+        Returns:
+            Random integer.
+        """
+        return self.random.randint(min_value, max_value)
+
+    def uniform(self, min_value: float, max_value: float) -> float:
+        """Get a random float in a range.
+
+        Args:
+            min_value: Lower bound.
+            max_value: Upper bound.
+
+        Returns:
+            Random float.
+        """
+        return self.random.uniform(min_value, max_value)
+
+    def chance(self, probability: float) -> bool:
+        """Roll against a probability.
+
+        Args:
+            probability: Chance of returning True (0..1).
+
+        Returns:
+            True with the given probability.
+        """
+        return self.random.random() < probability
+
+    def choice(self, items: List[Any]) -> Any:
+        """Pick a random item.
+
+        Args:
+            items: Non-empty list to pick from.
+
+        Returns:
+            One of the items.
+        """
+        return self.random.choice(items)
+
+
+class Timer:
+    """Handle for a callback or task scheduled with TimerService.
+
+    Attributes:
+        deadline: Scene time the timer is due next.
+        interval: Repeat interval for every(), otherwise 0.
+        is_done: True once the timer has fired (one-shot), finished (task), or been cancelled.
+    """
+    __slots__ = ("deadline", "callback", "interval", "task", "is_done")
+
+    def __init__(self, deadline: float, callback: Optional[Callable[[], None]] = None, interval: float = 0.0,
+                 task: Optional[Generator[Optional[float], None, None]] = None) -> None:
+        """Create the timer.
+
+        Args:
+            deadline: Scene time the timer is due first.
+            callback: Function to call when due (after, every).
+            interval: Repeat interval, or 0 for a one-shot timer.
+            task: Generator to resume when due (start).
+
+        Returns:
+            None
+        """
+        self.deadline = deadline
+        self.callback = callback
+        self.interval = interval
+        self.task = task
+        self.is_done = False
+
+    def cancel(self) -> None:
+        """Stop the timer. Its heap entry is dropped when it comes due.
+
+        Returns:
+            None
+        """
+        self.is_done = True
+
+
+class TimerService(Service):
+    """Scene clock with a min-heap of deadlines.
+
+    Callbacks (after, every) and generator tasks (start) sit in a heap keyed by
+    deadline, and update only touches the ones that are due, so idle timers
+    cost nothing per frame. A task yields the number of seconds to wait, or
+    None to wait one frame:
+
+        def flash(self):
+            self.sprite.is_visible = False
+            yield 0.1
+            self.sprite.is_visible = True
+
+        timers.start(self.flash())
+
+    Short gameplay windows (coyote time, jump buffering, cooldowns) don't need
+    the heap at all: store deadline(duration) and compare with time. Deadlines
+    are plain floats, so SnapshotService can roll them back (register time
+    too); heap timers and tasks are not part of snapshots. Add this service
+    before the services and objects that read time.
+
+    Attributes:
+        time: Seconds simulated by the scene so far.
+    """
+    def __init__(self) -> None:
+        """Create the service with the clock at 0.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.time = 0.0
+        self.heap: List[Tuple[float, int, Timer]] = []
+        self.pending: List[Timer] = []
+        self.sequence = 0
+        self.is_updating = False
+
+    def update(self, delta_time: float) -> None:
+        """Advance the clock and run everything that is due.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        self.time += delta_time
+        heap = self.heap
+        # Summed frame times fall just short of round deadlines; don't lose a frame to that.
+        due = self.time + 1e-9
+        self.is_updating = True
+        while heap and heap[0][0] <= due:
+            timer = heapq.heappop(heap)[2]
+            if timer.is_done:
+                continue
+            if timer.task is not None:
+                self._resume(timer)
+            else:
+                timer.callback()
+                if timer.interval > 0.0 and not timer.is_done:
+                    timer.deadline += timer.interval
+                    self._push(timer)
+                else:
+                    timer.is_done = True
+        self.is_updating = False
+        # Timers scheduled while running were held back so a zero wait lasts a frame.
+        for timer in self.pending:
+            self._push(timer)
+        self.pending.clear()
+
+    def _push(self, timer: Timer) -> None:
+        """Add a timer to the heap (or hold it until the current update finishes).
+
+        Args:
+            timer: Timer to schedule.
+
+        Returns:
+            None
+        """
+        if self.is_updating:
+            self.pending.append(timer)
+            return
+        heapq.heappush(self.heap, (timer.deadline, self.sequence, timer))
+        self.sequence += 1
+
+    def _resume(self, timer: Timer) -> None:
+        """Run a task until its next yield and reschedule it.
+
+        Args:
+            timer: Timer wrapping the task.
+
+        Returns:
+            None
+        """
+        try:
+            delay = next(timer.task)
+        except StopIteration:
+            timer.is_done = True
+            return
+        if delay is None:
+            timer.deadline = self.time
+        else:
+            # Measured from the deadline, not the frame, so repeated waits don't drift.
+            timer.deadline += delay
+        self._push(timer)
+
+    def deadline(self, delay: float) -> float:
+        """Get the scene time delay seconds from now.
+
+        Args:
+            delay: Seconds from now.
+
+        Returns:
+            Scene time to compare against time.
+        """
+        return self.time + delay
+
+    def after(self, delay: float, callback: Callable[[], None]) -> Timer:
+        """Call a function once after a delay.
+
+        Args:
+            delay: Seconds to wait.
+            callback: Function to call.
+
+        Returns:
+            Timer handle.
+        """
+        timer = Timer(self.time + delay, callback)
+        self._push(timer)
+        return timer
+
+    def every(self, interval: float, callback: Callable[[], None], delay: Optional[float] = None) -> Timer:
+        """Call a function repeatedly.
+
+        Args:
+            interval: Seconds between calls.
+            callback: Function to call.
+            delay: Seconds before the first call, or None for one interval.
+
+        Returns:
+            Timer handle; cancel it to stop.
+        """
+        timer = Timer(self.time + (interval if delay is None else delay), callback, interval)
+        self._push(timer)
+        return timer
+
+    def start(self, task: Generator[Optional[float], None, None]) -> Timer:
+        """Start a generator task. It runs up to its first yield immediately.
+
+        Args:
+            task: Generator yielding seconds to wait (or None for one frame).
+
+        Returns:
+            Timer handle; cancel it to stop the task.
+        """
+        timer = Timer(self.time, task=task)
+        self._resume(timer)
+        return timer
+
+
 class TextureService(Service):
     """Cache textures so they are loaded once.
 
@@ -106,13 +399,29 @@ class TextureService(Service):
             filename: Path to the texture file.
 
         Returns:
-            The loaded Texture2D.
+            The loaded Texture2D. In a headless game, an empty texture with the image's size.
         """
 
         if filename not in self.textures:
-            self.textures[filename] = rl.load_texture(filename)
+            if self.scene.game.headless:
+                image = rl.load_image(filename)
+                self.textures[filename] = rl.Texture2D(0, image.width, image.height, 1, image.format)
+                rl.unload_image(image)
+            else:
+                self.textures[filename] = rl.load_texture(filename)
         return self.textures[filename]
 
+    def unload(self) -> None:
+        """Unload every cached texture (headless placeholders own no GPU memory).
+
+        Returns:
+            None
+        """
+        if not self.scene.game.headless:
+            for texture in self.textures.values():
+                rl.unload_texture(texture)
+        self.textures.clear()
+
 
 class SoundService(Service):
     """Cache sounds and create aliases for overlapping playback.
@@ -124,25 +433,1176 @@ class SoundService(Service):
         super().__init__()
         self.sounds: Dict[str, List[Any]] = {}
 
-    def get_sound(self, filename: str):
-        """Get or load a sound; returns an alias if already loaded.
+    def get_sound(self, filename: str):
+        """Get or load a sound; returns an alias if already loaded.
+
+        Args:
+            filename: Path to the sound file.
+
+        Returns:
+            A Sound instance (original or alias), or None in a headless game.
+        """
+
+        if self.scene.game.headless:
+            return None
+        if filename not in self.sounds:
+            self.sounds[filename] = [rl.load_sound(filename)]
+        else:
+            self.sounds[filename].append(rl.load_sound_alias(self.sounds[filename][0]))
+        return self.sounds[filename][-1]
+
+    def unload(self) -> None:
+        """Unload every alias, then the sound it aliases.
+
+        Returns:
+            None
+        """
+        for sound, *aliases in self.sounds.values():
+            for alias in aliases:
+                rl.unload_sound_alias(alias)
+            rl.unload_sound(sound)
+        self.sounds.clear()
+
+
+class AnimationSystem(Service):
+    """Advance all registered animations in one vectorized pass per frame.
+
+    Animations bound to the system keep their frame timer and frame index in
+    shared arrays (one slot per animation) instead of on the Animation object,
+    so the cost of animating does not grow with per-object Python overhead.
+
+    Attributes:
+        timers: Seconds left on the current frame, per slot.
+        offsets: Start of each slot's frame durations in the durations pool.
+        frames: Current frame index, per slot. Read by Animation when drawing.
+        frame_counts: Number of frames, per slot.
+        loops: True if the slot wraps to the first frame, per slot.
+        running: True if the slot advances this frame.
+        durations: Pool of per-frame durations in seconds, shared by all slots.
+        count: Number of slots in use, including freed slots below the high-water mark.
+        free_ranges: (offset, length) ranges of the pool released by remove, sorted by offset.
+    """
+    def __init__(self, capacity: int = 64) -> None:
+        """Create the service.
+
+        Args:
+            capacity: Initial number of slots.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.capacity = 0
+        self.count = 0
+        self.free_slots: List[int] = []
+        self.timers = np.zeros(0, dtype=np.float64)
+        self.offsets = np.zeros(0, dtype=np.int64)
+        self.frames = np.zeros(0, dtype=np.int32)
+        self.frame_counts = np.zeros(0, dtype=np.int32)
+        self.loops = np.zeros(0, dtype=np.bool_)
+        self.running = np.zeros(0, dtype=np.bool_)
+        self.durations = np.zeros(0, dtype=np.float64)
+        self.durations_used = 0
+        self.free_ranges: List[Tuple[int, int]] = []
+        self._grow(max(1, capacity))
+
+    def _grow(self, capacity: int) -> None:
+        """Resize the slot arrays, keeping existing values.
+
+        Args:
+            capacity: New number of slots.
+
+        Returns:
+            None
+        """
+        def resize(array: np.ndarray) -> np.ndarray:
+            resized = np.zeros(capacity, dtype=array.dtype)
+            resized[:len(array)] = array
+            return resized
+
+        self.timers = resize(self.timers)
+        self.offsets = resize(self.offsets)
+        self.frames = resize(self.frames)
+        self.frame_counts = resize(self.frame_counts)
+        self.loops = resize(self.loops)
+        self.running = resize(self.running)
+        self.capacity = capacity
+
+    def add(self, durations: List[float], loop: bool) -> int:
+        """Allocate a slot for an animation.
+
+        Args:
+            durations: Seconds each frame is shown.
+            loop: True to wrap to the first frame.
+
+        Returns:
+            The slot index. The slot starts paused on frame 0.
+        """
+        if self.free_slots:
+            slot = self.free_slots.pop()
+        else:
+            if self.count >= self.capacity:
+                self._grow(self.capacity * 2)
+            slot = self.count
+            self.count += 1
+        frame_count = len(durations)
+        offset = self._allocate_durations(frame_count)
+        self.durations[offset:offset + frame_count] = durations
+        self.offsets[slot] = offset
+        self.timers[slot] = durations[0] if durations else 0.0
+        self.frames[slot] = 0
+        self.frame_counts[slot] = frame_count
+        self.loops[slot] = loop
+        self.running[slot] = False
+        return slot
+
+    def remove(self, slot: int) -> None:
+        """Release a slot so it can be reused.
+
+        Args:
+            slot: Slot index returned by add.
+
+        Returns:
+            None
+        """
+        self.running[slot] = False
+        self._free_durations(int(self.offsets[slot]), int(self.frame_counts[slot]))
+        self.frame_counts[slot] = 0
+        self.free_slots.append(slot)
+
+    def _allocate_durations(self, length: int) -> int:
+        """Reserve a range of the durations pool, reusing freed ranges first.
+
+        Args:
+            length: Number of durations.
+
+        Returns:
+            Offset of the range.
+        """
+        for i, (offset, free_length) in enumerate(self.free_ranges):
+            if free_length >= length:
+                if free_length == length:
+                    del self.free_ranges[i]
+                else:
+                    self.free_ranges[i] = (offset + length, free_length - length)
+                return offset
+        if self.durations_used + length > len(self.durations):
+            pool = np.zeros(max(2 * len(self.durations), self.durations_used + length), dtype=np.float64)
+            pool[:self.durations_used] = self.durations[:self.durations_used]
+            self.durations = pool
+        offset = self.durations_used
+        self.durations_used += length
+        return offset
+
+    def _free_durations(self, offset: int, length: int) -> None:
+        """Return a range to the durations pool, merging it with free neighbours.
+
+        Args:
+            offset: Offset returned by _allocate_durations.
+            length: Number of durations.
+
+        Returns:
+            None
+        """
+        if length == 0:
+            return
+        ranges = self.free_ranges
+        i = bisect.bisect(ranges, (offset, length))
+        if i < len(ranges) and offset + length == ranges[i][0]:
+            length += ranges.pop(i)[1]
+        if i > 0 and ranges[i - 1][0] + ranges[i - 1][1] == offset:
+            i -= 1
+            offset, length = ranges[i][0], ranges[i][1] + length
+            ranges.pop(i)
+        if offset + length == self.durations_used:
+            # Free space at the end of the pool goes back to the unused tail.
+            self.durations_used = offset
+        else:
+            ranges.insert(i, (offset, length))
+
+    def update(self, delta_time: float) -> None:
+        """Advance every running slot by delta time.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        n = self.count
+        if n == 0:
+            return
+        running = self.running[:n]
+        timers = self.timers[:n]
+        timers[running] -= delta_time
+        fired = running & (timers <= 0.0)
+        if not fired.any():
+            return
+        frames = self.frames[:n]
+        frames[fired] += 1
+        counts = self.frame_counts[:n]
+        wrapped = fired & (frames >= counts)
+        frames[wrapped] = np.where(self.loops[:n][wrapped], 0, counts[wrapped] - 1)
+        timers[fired] = self.durations[self.offsets[:n][fired] + frames[fired]]
+
+
+class CrowdService(Service):
+    """Steer many top-down agents toward targets in one vectorized step.
+
+    Agents are Box2D bodies registered with the service. Every frame the
+    service gathers positions and velocities from the bodies, computes seeking
+    toward the closest target plus separation from nearby agents (through a
+    spatial hash), applies the same acceleration, friction, and speed clamp as
+    TopDownMovementComponent, then writes every velocity back in one pass.
+    Agents whose body is inactive are skipped. With retarget_interval N > 1,
+    only 1/N of the agents (staggered by slot) look for a new closest target
+    each frame; the others keep seeking their previous one.
+
+    With lod_bands, agents far from the target they seek are steered less
+    often: each agent's steer_interval is set from its target distance like
+    TickLodService's tick_lod, and an agent steered every N frames is only
+    gathered, steered, and written back on 1 of N frames (staggered by slot),
+    with N frames' worth of acceleration. Box2D keeps moving it in between,
+    and the other agents separate from its last gathered position.
+
+    Add it after PhysicsService so velocities written here are used by the next
+    physics step.
+
+    Attributes:
+        positions: (N, 2) agent positions in pixels, refreshed every frame.
+        velocities: (N, 2) agent velocities in pixels/sec.
+        directions: (N, 2) steering input per agent (length <= 1).
+        facing: Facing angle per agent in degrees.
+        max_speed: Maximum speed per agent in pixels/sec.
+        accel: Acceleration per agent in pixels/sec^2.
+        friction: Deceleration per agent when not steering, in pixels/sec^2.
+        active: True if the agent's body was active when it was last gathered.
+        target_index: Index into targets of the target each agent seeks (-1 = none yet).
+        steer_interval: Frames between steering updates per agent (1 without lod_bands).
+        targets: Bodies the agents seek.
+    """
+    def __init__(self,
+                 separation_radius: float = 32.0,
+                 separation_weight: float = 1.0,
+                 deadzone: float = 0.1,
+                 capacity: int = 64,
+                 retarget_interval: int = 1,
+                 lod_bands: Optional[List[Tuple[float, int]]] = None) -> None:
+        """Create the service.
+
+        Args:
+            separation_radius: Distance in pixels under which agents push each other apart.
+            separation_weight: Strength of separation relative to seeking.
+            deadzone: Steering length under which friction is applied instead of acceleration.
+            capacity: Initial number of agent slots.
+            retarget_interval: Frames between closest-target searches per agent.
+            lod_bands: (distance, steer interval) pairs; agents closer to their target than distance
+                are steered every interval frames, agents beyond every band use the last interval.
+                None steers every agent every frame.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.separation_radius = separation_radius
+        self.separation_weight = separation_weight
+        self.deadzone = deadzone
+        self.retarget_interval = max(1, retarget_interval)
+        self.lod_distances: Optional[np.ndarray] = None
+        self.lod_intervals: Optional[np.ndarray] = None
+        self.max_steer_interval = 1
+        if lod_bands:
+            bands = sorted(lod_bands)
+            self.lod_distances = np.array([distance for distance, _ in bands], dtype=np.float64)
+            self.lod_intervals = np.array([max(1, interval) for _, interval in bands] + [max(1, bands[-1][1])],
+                                          dtype=np.int64)
+            self.max_steer_interval = int(self.lod_intervals.max())
+        self.frame = 0
+        self.target_count = 0
+        self.physics: Optional[PhysicsService] = None
+        self.hash = SpatialHash(separation_radius)
+        self.bodies: List[Optional[b2Body]] = []
+        self.targets: List[Any] = []
+        self.free_slots: List[int] = []
+        self.capacity = 0
+        self.positions = np.zeros((0, 2), dtype=np.float64)
+        self.velocities = np.zeros((0, 2), dtype=np.float64)
+        self.directions = np.zeros((0, 2), dtype=np.float64)
+        self.facing = np.zeros(0, dtype=np.float64)
+        self.max_speed = np.zeros(0, dtype=np.float64)
+        self.accel = np.zeros(0, dtype=np.float64)
+        self.friction = np.zeros(0, dtype=np.float64)
+        self.active = np.zeros(0, dtype=np.bool_)
+        self.target_index = np.zeros(0, dtype=np.int64)
+        self.steer_interval = np.zeros(0, dtype=np.int64)
+        self.steered_frame = np.zeros(0, dtype=np.int64)
+        self._grow(max(1, capacity))
+
+    def init(self) -> None:
+        """Resolve PhysicsService.
+
+        Returns:
+            None
+        """
+        self.physics = self.scene.get_service(PhysicsService)
+
+    def _grow(self, capacity: int) -> None:
+        """Resize the agent arrays, keeping existing values.
+
+        Args:
+            capacity: New number of slots.
+
+        Returns:
+            None
+        """
+        def resize(array: np.ndarray) -> np.ndarray:
+            resized = np.zeros((capacity,) + array.shape[1:], dtype=array.dtype)
+            resized[:len(array)] = array
+            return resized
+
+        self.positions = resize(self.positions)
+        self.velocities = resize(self.velocities)
+        self.directions = resize(self.directions)
+        self.facing = resize(self.facing)
+        self.max_speed = resize(self.max_speed)
+        self.accel = resize(self.accel)
+        self.friction = resize(self.friction)
+        self.active = resize(self.active)
+        self.target_index = resize(self.target_index)
+        self.steer_interval = resize(self.steer_interval)
+        self.steered_frame = resize(self.steered_frame)
+        self.capacity = capacity
+
+    def add_agent(self, body: b2Body, max_speed: float, accel: float, friction: float) -> int:
+        """Register a body as an agent.
+
+        Args:
+            body: Box2D body moved by the service.
+            max_speed: Maximum speed in pixels/sec.
+            accel: Acceleration in pixels/sec^2.
+            friction: Deceleration when not steering, in pixels/sec^2.
+
+        Returns:
+            Slot index of the agent.
+        """
+        if self.free_slots:
+            slot = self.free_slots.pop()
+            self.bodies[slot] = body
+        else:
+            slot = len(self.bodies)
+            if slot >= self.capacity:
+                self._grow(self.capacity * 2)
+            self.bodies.append(body)
+        self.positions[slot] = 0.0
+        self.velocities[slot] = 0.0
+        self.directions[slot] = 0.0
+        self.facing[slot] = 0.0
+        self.max_speed[slot] = max_speed
+        self.accel[slot] = accel
+        self.friction[slot] = friction
+        self.active[slot] = False
+        self.target_index[slot] = -1
+        self.steer_interval[slot] = 1
+        self.steered_frame[slot] = self.frame
+        return slot
+
+    def remove_agent(self, slot: int) -> None:
+        """Release an agent slot. CrowdAgentComponent calls this when it is unloaded.
+
+        Args:
+            slot: Slot returned by add_agent.
+
+        Returns:
+            None
+        """
+        self.bodies[slot] = None
+        self.active[slot] = False
+        self.free_slots.append(slot)
+
+    def add_target(self, target: Any) -> None:
+        """Add a target for agents to seek. Each agent seeks the closest target.
+
+        Args:
+            target: Object with get_position_pixels(), such as a BodyComponent.
+
+        Returns:
+            None
+        """
+        self.targets.append(target)
+
+    def remove_target(self, target: Any) -> None:
+        """Stop seeking a target.
+
+        Args:
+            target: Target previously passed to add_target.
+
+        Returns:
+            None
+        """
+        if target in self.targets:
+            self.targets.remove(target)
+
+    def update(self, delta_time: float) -> None:
+        """Gather the agents due this frame, steer them, and write their velocities back.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        n = len(self.bodies)
+        if n == 0 or not self.physics:
+            return
+        to_pixels = self.physics.meters_to_pixels
+        self.frame += 1
+
+        # Gather: one pass over the bodies due this frame (all of them without LOD).
+        if self.lod_intervals is None:
+            due_slots = range(n)
+        else:
+            due_slots = np.flatnonzero((np.arange(n) + self.frame) % self.steer_interval[:n] == 0).tolist()
+        bodies = self.bodies
+        active = self.active
+        gathered = []
+        steered = []
+        for slot in due_slots:
+            body = bodies[slot]
+            is_active = body is not None and body.active
+            active[slot] = is_active
+            if is_active:
+                position = body.position
+                velocity = body.linearVelocity
+                gathered.append((position.x, position.y, velocity.x, velocity.y))
+                steered.append(slot)
+        if not gathered:
+            return
+        slots = np.array(steered, dtype=np.int64)
+        state = np.array(gathered, dtype=np.float64) * to_pixels
+        self.positions[slots] = state[:, 0:2]
+        positions = state[:, 0:2]
+        velocities = state[:, 2:4]
+        # Frames since each agent was last steered; an agent reactivated from a pool counts as one interval.
+        step_time = delta_time * np.minimum(self.frame - self.steered_frame[slots], self.max_steer_interval)
+        self.steered_frame[slots] = self.frame
+
+        # Seek the closest target. Agents that are not due keep their previous
+        # target; everyone searches again when the target list changes.
+        directions = np.zeros_like(positions)
+        if self.targets:
+            target_positions = np.array([(p.x, p.y) for p in (t.get_position_pixels() for t in self.targets)],
+                                        dtype=np.float64)
+            target_index = self.target_index[slots]
+            if self.retarget_interval > 1 and len(self.targets) == self.target_count:
+                due = ((slots + self.frame) % self.retarget_interval == 0) | (target_index < 0)
+            else:
+                due = np.ones(len(slots), dtype=np.bool_)
+            self.target_count = len(self.targets)
+            if due.any():
+                to_targets = target_positions[np.newaxis, :, :] - positions[due][:, np.newaxis, :]
+                dist_sq = np.einsum("ntk,ntk->nt", to_targets, to_targets)
+                target_index[due] = np.argmin(dist_sq, axis=1)
+                self.target_index[slots] = target_index
+            directions = target_positions[target_index] - positions
+            lengths = np.sqrt(np.einsum("ij,ij->i", directions, directions))
+            np.divide(directions, lengths[:, np.newaxis], out=directions, where=lengths[:, np.newaxis] > 0.0)
+            if self.lod_intervals is not None:
+                self.steer_interval[slots] = self.lod_intervals[np.searchsorted(self.lod_distances, lengths,
+                                                                                side="right")]
+
+        # Separation from agents closer than separation_radius, including agents
+        # not steered this frame at their last gathered position.
+        if self.separation_weight > 0.0:
+            if self.lod_intervals is None:
+                others = slots
+                other_positions = positions
+            else:
+                others = np.flatnonzero(active[:n])
+                other_positions = self.positions[others]
+            if len(others) > 1:
+                self.hash.build(other_positions)
+                i, j = self.hash.query_pairs(self.separation_radius)
+                if len(others) != len(slots):
+                    rows = np.full(n, -1, dtype=np.int64)
+                    rows[slots] = np.arange(len(slots))
+                    i = rows[others[i]]
+                    keep = i >= 0
+                    i, j = i[keep], j[keep]
+                if len(i):
+                    delta = positions[i] - other_positions[j]
+                    dist = np.sqrt(np.einsum("ij,ij->i", delta, delta))
+                    strength = np.zeros_like(dist)
+                    np.divide(1.0 - dist / self.separation_radius, dist, out=strength, where=dist > 1e-5)
+                    push = delta * (strength * self.separation_weight)[:, np.newaxis]
+                    directions[:, 0] += np.bincount(i, weights=push[:, 0], minlength=len(positions))
+                    directions[:, 1] += np.bincount(i, weights=push[:, 1], minlength=len(positions))
+                lengths = np.sqrt(np.einsum("ij,ij->i", directions, directions))
+                too_long = lengths > 1.0
+                directions[too_long] /= lengths[too_long][:, np.newaxis]
+
+        # Accelerate toward the desired velocity, or apply friction, over the
+        # frames since each agent was last steered.
+        max_speed = self.max_speed[slots]
+        input_len_sq = np.einsum("ij,ij->i", directions, directions)
+        steering = input_len_sq > self.deadzone * self.deadzone
+
+        desired = directions * max_speed[:, np.newaxis]
+        delta = desired - velocities
+        delta_len = np.sqrt(np.einsum("ij,ij->i", delta, delta))
+        max_delta = self.accel[slots] * step_time
+        step = np.ones_like(delta_len)
+        np.divide(max_delta, delta_len, out=step, where=delta_len > max_delta)
+        accelerated = velocities + delta * step[:, np.newaxis]
+
+        speed = np.sqrt(np.einsum("ij,ij->i", velocities, velocities))
+        slowed_speed = np.maximum(speed - self.friction[slots] * step_time, 0.0)
+        scale = np.zeros_like(speed)
+        np.divide(slowed_speed, speed, out=scale, where=speed > 1e-5)
+        slowed = velocities * scale[:, np.newaxis]
+
+        velocities = np.where(steering[:, np.newaxis], accelerated, slowed)
+        speed = np.sqrt(np.einsum("ij,ij->i", velocities, velocities))
+        over = speed > max_speed
+        velocities[over] *= (max_speed[over] / speed[over])[:, np.newaxis]
+
+        facing_slots = slots[steering]
+        self.facing[facing_slots] = np.degrees(np.arctan2(directions[steering, 1], directions[steering, 0]))
+        self.directions[slots] = directions
+        self.velocities[slots] = velocities
+
+        # Write back: one pass over the steered bodies.
+        for slot, (vx, vy) in zip(steered, (velocities / to_pixels).tolist()):
+            bodies[slot].linearVelocity = b2Vec2(vx, vy)
+
+
+class TickLodService(Service):
+    """Lower the tick rate of objects that are far from every viewer.
+
+    Objects are registered with the BodyComponent that gives their position.
+    Every refresh_interval frames the service measures the distance from each
+    object to the nearest viewer (cameras or players) and sets the object's
+    tick_lod from the first band whose distance it is under; objects beyond
+    every band use the last band's multiplier. Objects whose owner is
+    inactive (waiting in a pool) are skipped.
+
+    Add it after PhysicsService so positions come from the current step.
+
+    Attributes:
+        distances: Band upper distances in pixels, ascending.
+        multipliers: tick_lod per band, plus one for beyond the last band.
+        entries: (object, body component) pairs.
+        viewers: Callables returning a viewer position in pixels.
+    """
+    def __init__(self,
+                 bands: Optional[List[Tuple[float, int]]] = None,
+                 refresh_interval: int = 10) -> None:
+        """Create the service.
+
+        Args:
+            bands: (distance, tick_lod) pairs; objects closer than distance use tick_lod.
+            refresh_interval: Frames between distance checks.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        bands = sorted(bands or [(400.0, 1), (800.0, 2), (1600.0, 4)])
+        self.distances = np.array([distance for distance, _ in bands], dtype=np.float64)
+        self.multipliers = np.array([lod for _, lod in bands] + [bands[-1][1]], dtype=np.int64)
+        self.refresh_interval = max(1, refresh_interval)
+        self.countdown = 0
+        self.physics: Optional[PhysicsService] = None
+        self.entries: List[Tuple[Any, Any]] = []
+        self.viewers: List[Callable[[], Any]] = []
+
+    def init(self) -> None:
+        """Resolve PhysicsService.
+
+        Returns:
+            None
+        """
+        self.physics = self.scene.get_service(PhysicsService)
+
+    def add(self, target: Any, body_component: Any) -> None:
+        """Register an object whose tick rate follows its distance to the viewers.
+
+        Args:
+            target: GameObject or Component with set_tick_lod().
+            body_component: BodyComponent giving the object's position.
+
+        Returns:
+            None
+        """
+        self.entries.append((target, body_component))
+
+    def remove(self, target: Any) -> None:
+        """Stop adjusting an object and restore its full tick rate.
+
+        Args:
+            target: Object previously passed to add.
+
+        Returns:
+            None
+        """
+        self.entries = [entry for entry in self.entries if entry[0] is not target]
+        target.set_tick_lod(1)
+
+    def add_viewer(self, get_position: Callable[[], Any]) -> None:
+        """Add a point that keeps nearby objects at full rate.
+
+        Args:
+            get_position: Callable returning a position in pixels, such as a camera target.
+
+        Returns:
+            None
+        """
+        self.viewers.append(get_position)
+
+    def update(self, delta_time: float) -> None:
+        """Reassign tick_lod from the nearest viewer distance every refresh_interval frames.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        self.countdown -= 1
+        if self.countdown > 0:
+            return
+        self.countdown = self.refresh_interval
+        # Pooled objects waiting for reuse keep their last rate until they are active again.
+        entries = [(target, body) for target, body in self.entries if body.slot >= 0 and body.owner.is_active]
+        if not entries or not self.viewers:
+            return
+        positions = self.physics.positions[[body.slot for _, body in entries]]
+        viewers = np.array([(p.x, p.y) for p in (get_position() for get_position in self.viewers)],
+                           dtype=np.float64)
+        offsets = positions[:, np.newaxis, :] - viewers[np.newaxis, :, :]
+        nearest = np.sqrt(np.einsum("nvk,nvk->nv", offsets, offsets).min(axis=1))
+        lods = self.multipliers[np.searchsorted(self.distances, nearest, side="right")]
+        for (target, _), lod in zip(entries, lods.tolist()):
+            if target.tick_lod != lod:
+                target.set_tick_lod(lod)
+
+
+class ParticleEmitter:
+    """Settings for a kind of particle, and an optional continuous source.
+
+    Bursts are spawned with ParticleService.emit. Emitters added with
+    ParticleService.add_emitter also spawn rate particles per second at
+    position while is_active; position and rotation can be driven by
+    BodyComponent.follow or TransformComponent.follow.
+
+    Attributes:
+        position: Spawn position in pixels.
+        rotation: Rotation in degrees, added to direction.
+        rate: Particles per second spawned while is_active (continuous emitters).
+        is_active: Spawn rate particles while True.
+        direction: Launch direction in degrees.
+        spread: Width in degrees of the launch cone centred on direction.
+        speed_min: Minimum launch speed in pixels/sec.
+        speed_max: Maximum launch speed in pixels/sec.
+        life_min: Minimum life in seconds.
+        life_max: Maximum life in seconds.
+        size: Width of a particle in pixels when spawned.
+        size_end: Width in pixels at the end of its life.
+        color: Color when spawned.
+        color_end: Color at the end of its life.
+        gravity: Acceleration in pixels/sec^2.
+        drag: Fraction of velocity lost per second.
+        bounce: Velocity kept along the blocked axis when hitting the level (0 = stop, 1 = full bounce).
+        accumulator: Fractional particles carried over between frames.
+    """
+    def __init__(self) -> None:
+        """Create an emitter with default settings.
+
+        Returns:
+            None
+        """
+        self.position = v2(0.0, 0.0)
+        self.rotation = 0.0
+        self.rate = 0.0
+        self.is_active = True
+        self.direction = 0.0
+        self.spread = 360.0
+        self.speed_min = 50.0
+        self.speed_max = 150.0
+        self.life_min = 0.4
+        self.life_max = 0.8
+        self.size = 4.0
+        self.size_end = 0.0
+        self.color = rl.Color(255, 255, 255, 255)
+        self.color_end = rl.Color(255, 255, 255, 0)
+        self.gravity = v2(0.0, 0.0)
+        self.drag = 0.0
+        self.bounce = 0.3
+        self.accumulator = 0.0
+
+
+class ParticleService(Service):
+    """Simulate and draw many small particles as structure-of-arrays.
+
+    Live particles are packed at the front of fixed-capacity NumPy arrays.
+    Each frame they are advanced in one vectorized pass (gravity, drag,
+    optional bounce off the level's solid IntGrid cells), dead ones are
+    replaced by live ones moved down from the end (so order is not kept),
+    and colors and sizes are interpolated over each particle's life.
+    Drawing culls particles outside the current view and uploads the rest
+    as one dynamic mesh drawn with a single draw call, so it works once per
+    camera. Spawns beyond capacity are dropped.
+
+    At 50k live particles on one slow core, update with level collision
+    takes under 2 ms and draw about 3 ms per camera to fill the vertex and
+    color buffers, plus the upload, so roughly a third of a 60 FPS frame.
+
+    Add it after LevelService when colliding with the level, so particles
+    draw over the level layers.
+
+    Attributes:
+        count: Number of live particles.
+        positions: (capacity, 2) positions in pixels.
+        velocities: (capacity, 2) velocities in pixels/sec.
+        life: Seconds left per particle.
+        max_life: Initial life per particle.
+        emitters: Continuous emitters.
+    """
+    DRAW_BLOCK = 4096
+
+    def __init__(self, capacity: int = 50000, collide_with_level: bool = False) -> None:
+        """Allocate particle storage.
+
+        Args:
+            capacity: Maximum live particles.
+            collide_with_level: True to bounce particles off LevelService's solid cells.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.capacity = capacity
+        self.collide_with_level = collide_with_level
+        self.count = 0
+        self.positions = np.zeros((capacity, 2), dtype=np.float32)
+        self.velocities = np.zeros((capacity, 2), dtype=np.float32)
+        self.gravity = np.zeros((capacity, 2), dtype=np.float32)
+        self.drag = np.zeros(capacity, dtype=np.float32)
+        self.bounce = np.zeros(capacity, dtype=np.float32)
+        self.life = np.zeros(capacity, dtype=np.float32)
+        self.max_life = np.ones(capacity, dtype=np.float32)
+        self.sizes = np.zeros(capacity, dtype=np.float32)
+        self.size_deltas = np.zeros(capacity, dtype=np.float32)
+        self.colors = np.zeros((capacity, 4), dtype=np.float32)
+        self.color_deltas = np.zeros((capacity, 4), dtype=np.float32)
+        self.emitters: List[ParticleEmitter] = []
+        self.random = np.random.default_rng(0)
+        # Solid cells with a one-cell empty border, flattened for lookups.
+        self.solid: Optional[np.ndarray] = None
+        self.solid_shape = (0, 0)
+        self.cells_per_pixel = 1.0
+        self.mesh: Any = None
+        self.material: Any = None
+        self.vertices = np.zeros((0, 3), dtype=np.float32)
+        self.vertex_colors = np.zeros((0, 4), dtype=np.uint8)
+
+    def init(self) -> None:
+        """Seed the generator, read the level's solid cells, and create the mesh.
+
+        Returns:
+            None
+        """
+        self.random = np.random.default_rng(self.scene.game.seed)
+        if self.collide_with_level and self.scene.has_service(LevelService):
+            grid = self.scene.get_service(LevelService).get_collision_grid()
+            if grid:
+                solid, cell_size = grid
+                padded = np.zeros((solid.shape[0] + 2, solid.shape[1] + 2), dtype=np.bool_)
+                padded[1:-1, 1:-1] = solid
+                self.solid = padded.ravel()
+                self.solid_shape = padded.shape
+                self.cells_per_pixel = 1.0 / cell_size
+        if self.scene.game.headless:
+            return
+        self.vertices = np.zeros((self.capacity * 6, 3), dtype=np.float32)
+        self.vertex_colors = np.zeros((self.capacity * 6, 4), dtype=np.uint8)
+        self.mesh = rl.Mesh()
+        self.mesh.vertexCount = self.capacity * 6
+        self.mesh.triangleCount = self.capacity * 2
+        self.mesh.vertices = rl.ffi.cast("float *", rl.ffi.from_buffer(self.vertices))
+        self.mesh.colors = rl.ffi.cast("unsigned char *", rl.ffi.from_buffer(self.vertex_colors))
+        rl.upload_mesh(self.mesh, True)
+        # The GPU has its own copy; raylib must never free the NumPy buffers.
+        self.mesh.vertices = rl.ffi.NULL
+        self.mesh.colors = rl.ffi.NULL
+        self.material = rl.load_material_default()
+
+    def unload(self) -> None:
+        """Free the mesh's GPU buffers and the material, and drop every particle and emitter.
+
+        Returns:
+            None
+        """
+        if self.mesh is not None:
+            rl.unload_mesh(self.mesh)
+            rl.unload_material(self.material)
+            self.mesh = None
+            self.material = None
+        self.count = 0
+        self.emitters.clear()
+
+    def add_emitter(self, emitter: ParticleEmitter) -> ParticleEmitter:
+        """Register a continuous emitter.
+
+        Args:
+            emitter: Emitter with rate > 0.
+
+        Returns:
+            The emitter.
+        """
+        self.emitters.append(emitter)
+        return emitter
+
+    def remove_emitter(self, emitter: ParticleEmitter) -> None:
+        """Stop a continuous emitter.
+
+        Args:
+            emitter: Emitter previously passed to add_emitter.
+
+        Returns:
+            None
+        """
+        if emitter in self.emitters:
+            self.emitters.remove(emitter)
+
+    def emit(self, emitter: ParticleEmitter, position: Any, count: int) -> None:
+        """Spawn a burst of particles.
+
+        Args:
+            emitter: Particle settings.
+            position: Spawn position in pixels.
+            count: Number of particles.
+
+        Returns:
+            None
+        """
+        count = min(count, self.capacity - self.count)
+        if count <= 0:
+            return
+        new = slice(self.count, self.count + count)
+        random = self.random
+        angles = np.radians(emitter.rotation + emitter.direction
+                            + (random.random(count) - 0.5) * emitter.spread)
+        speeds = random.uniform(emitter.speed_min, emitter.speed_max, count)
+        self.positions[new] = (position.x, position.y)
+        self.velocities[new, 0] = np.cos(angles) * speeds
+        self.velocities[new, 1] = np.sin(angles) * speeds
+        self.gravity[new] = (emitter.gravity.x, emitter.gravity.y)
+        self.drag[new] = emitter.drag
+        self.bounce[new] = emitter.bounce
+        life = random.uniform(emitter.life_min, emitter.life_max, count)
+        self.life[new] = life
+        self.max_life[new] = life
+        self.sizes[new] = emitter.size
+        self.size_deltas[new] = emitter.size_end - emitter.size
+        start, end = emitter.color, emitter.color_end
+        self.colors[new] = (start.r, start.g, start.b, start.a)
+        self.color_deltas[new] = (end.r - start.r, end.g - start.g, end.b - start.b, end.a - start.a)
+        self.count += count
+
+    def clear(self) -> None:
+        """Remove every live particle.
+
+        Returns:
+            None
+        """
+        self.count = 0
+
+    def update(self, delta_time: float) -> None:
+        """Spawn from emitters, advance all particles, and drop dead ones.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        for emitter in self.emitters:
+            if emitter.is_active and emitter.rate > 0.0:
+                emitter.accumulator += emitter.rate * delta_time
+                spawn = int(emitter.accumulator)
+                if spawn:
+                    emitter.accumulator -= spawn
+                    self.emit(emitter, emitter.position, spawn)
+
+        n = self.count
+        if n == 0:
+            return
+        life = self.life[:n]
+        life -= delta_time
+        alive = life > 0.0
+        if not alive.all():
+            # Fill the holes below the new count with the live particles above it;
+            # only the dead are touched, instead of compacting every array.
+            dead = np.flatnonzero(~alive)
+            n -= len(dead)
+            holes = dead[:np.searchsorted(dead, n)]
+            if len(holes):
+                moved = n + np.flatnonzero(alive[n:])
+                for array in (self.positions, self.velocities, self.gravity, self.drag, self.bounce, self.life,
+                              self.max_life, self.sizes, self.size_deltas, self.colors, self.color_deltas):
+                    array[holes] = array[moved]
+            self.count = n
+            if n == 0:
+                return
+
+        positions = self.positions[:n]
+        velocities = self.velocities[:n]
+        velocities += self.gravity[:n] * delta_time
+        velocities *= np.maximum(0.0, 1.0 - self.drag[:n] * delta_time)[:, np.newaxis]
+        if self.solid is None:
+            positions += velocities * delta_time
+            return
+
+        # Move one axis at a time; a particle entering a solid cell stays put on
+        # that axis and has its velocity reflected and damped. Cells outside the
+        # level clamp onto the empty border.
+        rows, columns = self.solid_shape
+        for axis in (0, 1):
+            moved = positions[:, axis] + velocities[:, axis] * delta_time
+            x = moved if axis == 0 else positions[:, 0]
+            y = moved if axis == 1 else positions[:, 1]
+            cx = np.clip(x * self.cells_per_pixel + 1.0, 0, columns - 1).astype(np.int32)
+            cy = np.clip(y * self.cells_per_pixel + 1.0, 0, rows - 1).astype(np.int32)
+            blocked = self.solid.take(cy * columns + cx)
+            if blocked.any():
+                np.copyto(moved, positions[:, axis], where=blocked)
+                hits = np.flatnonzero(blocked)
+                velocities[hits, axis] *= -self.bounce[hits]
+            positions[:, axis] = moved
+
+    def draw(self) -> None:
+        """Draw the particles inside the current view as one mesh.
+
+        Returns:
+            None
+        """
+        n = self.count
+        if n == 0 or self.mesh is None:
+            return
+        min_x, min_y, max_x, max_y = get_view_bounds()
+
+        t = 1.0 - self.life[:n] / self.max_life[:n]
+        half = (self.sizes[:n] + self.size_deltas[:n] * t) * 0.5
+        x = self.positions[:n, 0]
+        y = self.positions[:n, 1]
+        visible = (x + half >= min_x) & (x - half <= max_x) & (y + half >= min_y) & (y - half <= max_y) & (half > 0.0)
+        k = int(np.count_nonzero(visible))
+        if k == 0:
+            return
+        colors = self.colors[:n]
+        color_deltas = self.color_deltas[:n]
+        if k < n:
+            x, y, half, t = x[visible], y[visible], half[visible], t[visible]
+            colors, color_deltas = colors[visible], color_deltas[visible]
+
+        # Corners in raylib's quad order (top-left, bottom-left, bottom-right, top-right),
+        # split into two triangles. z stays 0. The strided corner writes go a block of
+        # rows at a time so the block stays in cache.
+        vertices = self.vertices[:k * 6].reshape(k, 18)
+        for start in range(0, k, self.DRAW_BLOCK):
+            block = slice(start, start + self.DRAW_BLOCK)
+            rows = vertices[block]
+            block_x, block_y, block_half = x[block], y[block], half[block]
+            x0 = block_x - block_half
+            x1 = block_x + block_half
+            y0 = block_y - block_half
+            y1 = block_y + block_half
+            for corner, (corner_x, corner_y) in enumerate(((x0, y0), (x0, y1), (x1, y1), (x0, y0), (x1, y1),
+                                                           (x1, y0))):
+                rows[:, corner * 3] = corner_x
+                rows[:, corner * 3 + 1] = corner_y
+        packed = (colors + color_deltas * t[:, np.newaxis]).astype(np.uint8).view(np.uint32)[:, 0]
+        self.vertex_colors[:k * 6].view(np.uint32).reshape(k, 6)[:] = packed[:, np.newaxis]
+
+        rl.update_mesh_buffer(self.mesh, 0, rl.ffi.from_buffer(self.vertices), k * 6 * 3 * 4, 0)
+        rl.update_mesh_buffer(self.mesh, 3, rl.ffi.from_buffer(self.vertex_colors), k * 6 * 4, 0)
+        self.mesh.vertexCount = k * 6
+        self.mesh.triangleCount = k * 2
+        # Shapes drawn so far are still batched; flush them so particles draw on top.
+        render.draw_render_batch_active()
+        render.draw_mesh(self.mesh, self.material, rl.matrix_identity())
+
+
+class _HashLayer:
+    """Entries registered under one tag, and the hash built from them."""
+    def __init__(self, cell_size: float) -> None:
+        self.entries: List[Any] = []
+        self.hash = SpatialHash(cell_size)
+        self.indices = np.zeros(0, dtype=np.int64)
+
+
+class SpatialHashService(Service):
+    """Per-tag uniform grids for proximity queries that do not need physics.
+
+    Bodies are registered under a tag (or any layer name). Once per frame every
+    layer is re-bucketed from the body positions in one pass, skipping inactive
+    objects and bodies. Queries return the owning GameObjects and never touch the
+    Box2D world, so AI, pickups, and audio culling can share one index.
+
+    Add it after PhysicsService so queries see positions from the current step.
+    """
+    def __init__(self, cell_size: float = 64.0) -> None:
+        """Create the service.
+
+        Args:
+            cell_size: Grid cell size in pixels. Close to the usual query radius works best.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.cell_size = cell_size
+        self.physics: Optional[PhysicsService] = None
+        self.layers: Dict[str, _HashLayer] = {}
+
+    def init(self) -> None:
+        """Resolve PhysicsService.
+
+        Returns:
+            None
+        """
+        self.physics = self.scene.get_service(PhysicsService)
+
+    def add(self, tag: str, body_component: Any) -> None:
+        """Register a body under a tag.
+
+        Args:
+            tag: Tag or layer name to index the body under.
+            body_component: BodyComponent whose owner is returned by queries.
+
+        Returns:
+            None
+        """
+        if tag not in self.layers:
+            self.layers[tag] = _HashLayer(self.cell_size)
+        self.layers[tag].entries.append(body_component)
+
+    def remove(self, tag: str, body_component: Any) -> None:
+        """Unregister a body. Takes effect at the next update.
+
+        Args:
+            tag: Tag the body was added under.
+            body_component: BodyComponent passed to add.
+
+        Returns:
+            None
+        """
+        layer = self.layers.get(tag)
+        if layer and body_component in layer.entries:
+            layer.entries.remove(body_component)
+
+    def update(self, delta_time: float) -> None:
+        """Re-bucket every layer from current body positions.
+
+        Args:
+            delta_time: Seconds since the last frame (unused).
+
+        Returns:
+            None
+        """
+        if not self.physics:
+            return
+        to_pixels = self.physics.meters_to_pixels
+        for layer in self.layers.values():
+            indices = []
+            positions = []
+            for index, entry in enumerate(layer.entries):
+                body = entry.body
+                if body is None or not body.active or not entry.owner.is_active:
+                    continue
+                position = body.position
+                indices.append(index)
+                positions.append((position.x, position.y))
+            layer.indices = np.array(indices, dtype=np.int64)
+            layer.hash.build(np.array(positions, dtype=np.float64).reshape(-1, 2) * to_pixels)
+
+    def _owners(self, layer: _HashLayer, found: np.ndarray) -> List[Any]:
+        """Map hash indices to the owning GameObjects.
+
+        Args:
+            layer: Layer the indices come from.
+            found: Indices into the layer's hash.
+
+        Returns:
+            List of GameObjects, in the same order.
+        """
+        entries = layer.entries
+        return [entries[index].owner for index in layer.indices[found].tolist()]
+
+    def query_radius(self, tag: str, center: Any, radius: float) -> List[Any]:
+        """Find objects within a radius.
+
+        Args:
+            tag: Layer to search.
+            center: Center in pixels.
+            radius: Radius in pixels.
+
+        Returns:
+            GameObjects whose body position is inside the circle.
+        """
+        layer = self.layers.get(tag)
+        if not layer:
+            return []
+        return self._owners(layer, layer.hash.query_radius(center.x, center.y, radius))
+
+    def query_rect(self, tag: str, rect: Any) -> List[Any]:
+        """Find objects inside a rectangle.
 
         Args:
-            filename: Path to the sound file.
+            tag: Layer to search.
+            rect: Rectangle (x, y, width, height) in pixels.
 
         Returns:
-            A Sound instance (original or alias).
+            GameObjects whose body position is inside the rectangle.
         """
+        layer = self.layers.get(tag)
+        if not layer:
+            return []
+        return self._owners(layer, layer.hash.query_rect(rect.x, rect.y, rect.width, rect.height))
 
-        if filename not in self.sounds:
-            self.sounds[filename] = [rl.load_sound(filename)]
-        else:
-            self.sounds[filename].append(rl.load_sound_alias(self.sounds[filename][0]))
-        return self.sounds[filename][-1]
+    def query_nearest(self, tag: str, center: Any, k: int = 1) -> List[Any]:
+        """Find the k objects closest to a position.
+
+        Args:
+            tag: Layer to search.
+            center: Query position in pixels.
+            k: Number of objects to return.
+
+        Returns:
+            Up to k GameObjects, closest first.
+        """
+        layer = self.layers.get(tag)
+        if not layer:
+            return []
+        return self._owners(layer, layer.hash.query_nearest(center.x, center.y, k))
 
 
 class PhysicsService(Service):
-    """Service that owns the Box2D world and physics configuration."""
+    """Service that owns the Box2D world and physics configuration.
+
+    After every step, the transforms of registered bodies are synced into a
+    pixel-space cache (positions and angles arrays, one row per BodyComponent)
+    and pushed into linked followers such as sprites and animation controllers.
+    Only awake, active, non-static bodies are read; the cache of everything
+    else is already current.
+
+    draw_debug keeps static shapes in a mesh that is rebuilt only when a static
+    body is created, destroyed, or moved; call invalidate_debug_cache after
+    adding or removing fixtures on an existing static body. If the game has a
+    JobManager, the mesh is rebuilt there over the following frames and the
+    previous one is drawn until it is ready. A rebuild dropped on scene exit is
+    restarted when the scene is drawn again.
+    """
     def __init__(self,
                  gravity: b2Vec2 = b2Vec2(0.0, 10.0),
                  time_step: float = 1.0 / 60.0,
@@ -156,9 +1616,20 @@ class PhysicsService(Service):
         self.pixels_to_meters = 1.0 / meters_to_pixels
         self.world: Optional[b2World] = None
         self.debug_draw = PhysicsDebugRenderer(meters_to_pixels=meters_to_pixels)
+        self.synced: List[Optional[Any]] = []
+        self.free_sync_slots: List[int] = []
+        self.positions = np.zeros((64, 2), dtype=np.float64)
+        self.angles = np.zeros(64, dtype=np.float64)
+        self.followers: List[Tuple[int, Any, bool]] = []
+        self.body_slots: Dict[b2Body, int] = {}
+        # Bumped whenever a slot is assigned or freed, so slot caches elsewhere know to rebuild.
+        self.slots_version = 0
+        self.debug_static_key: Optional[List[Tuple[float, float, float]]] = None
+        self.jobs: Optional[JobManager] = None
+        self.debug_job: Optional[Job] = None
 
     def init(self) -> None:
-        """Create the Box2D world.
+        """Create the Box2D world and resolve JobManager if the game has one.
 
         Returns:
             None
@@ -166,6 +1637,8 @@ class PhysicsService(Service):
         self.world = b2World(gravity=self.gravity, doSleep=True)
         self.world.contactListener = None
         self.world.renderer = self.debug_draw
+        game = self.scene.game
+        self.jobs = game.get_manager(JobManager) if game.has_manager(JobManager) else None
 
     def update(self, delta_time: float) -> None:
         """Step the physics world.
@@ -179,15 +1652,263 @@ class PhysicsService(Service):
         if not self.world:
             return
         self.world.Step(self.time_step, self.sub_steps, self.sub_steps)
+        self.sync_transforms()
+
+    def unload(self) -> None:
+        """Drop the world with every body in it, the transform cache, and the static debug mesh.
+
+        Returns:
+            None
+        """
+        if self.debug_job:
+            self.debug_job.cancel()
+            self.debug_job = None
+        self.debug_draw.unload_static()
+        self.debug_static_key = None
+        self.synced.clear()
+        self.free_sync_slots.clear()
+        self.followers.clear()
+        self.body_slots.clear()
+        self.slots_version += 1
+        self.world = None
+
+    def register_body(self, body_component: Any) -> int:
+        """Add a BodyComponent to the transform cache.
+
+        Args:
+            body_component: Component whose body is synced after each step.
+
+        Returns:
+            Slot index into positions and angles.
+        """
+        if self.free_sync_slots:
+            slot = self.free_sync_slots.pop()
+            self.synced[slot] = body_component
+        else:
+            slot = len(self.synced)
+            if slot >= len(self.angles):
+                capacity = len(self.angles) * 2
+                positions = np.zeros((capacity, 2), dtype=np.float64)
+                positions[:slot] = self.positions[:slot]
+                angles = np.zeros(capacity, dtype=np.float64)
+                angles[:slot] = self.angles[:slot]
+                self.positions = positions
+                self.angles = angles
+            self.synced.append(body_component)
+        if body_component.body is not None:
+            self.body_slots[body_component.body] = slot
+        self.slots_version += 1
+        self.refresh_body(slot)
+        return slot
+
+    def unregister_body(self, slot: int) -> None:
+        """Remove a BodyComponent and its followers from the transform cache.
+
+        Args:
+            slot: Slot returned by register_body.
+
+        Returns:
+            None
+        """
+        component = self.synced[slot]
+        if component is not None and component.body is not None:
+            self.body_slots.pop(component.body, None)
+        self.synced[slot] = None
+        self.followers = [follower for follower in self.followers if follower[0] != slot]
+        self.free_sync_slots.append(slot)
+        self.slots_version += 1
+
+    def body_sort_key(self, body: b2Body) -> Tuple[int, float, float]:
+        """Key that orders bodies the same way in every run.
+
+        Registered bodies sort by slot (registration order). Other bodies, such
+        as level collision, are static and sort after them by position.
+
+        Args:
+            body: Box2D body.
+
+        Returns:
+            Sort key.
+        """
+        slot = self.body_slots.get(body)
+        if slot is not None:
+            return slot, 0.0, 0.0
+        position = body.position
+        return len(self.synced), position.x, position.y
+
+    def checksum(self, crc: int = 0) -> int:
+        """CRC32 of the cached transforms of every registered body.
+
+        Two runs with the same input and seed must produce the same checksum
+        every frame; see tools/verify_determinism.py.
+
+        Args:
+            crc: Running checksum to continue from.
+
+        Returns:
+            Updated checksum.
+        """
+        count = len(self.synced)
+        crc = zlib.crc32(self.positions[:count].tobytes(), crc)
+        return zlib.crc32(self.angles[:count].tobytes(), crc)
+
+    def add_follower(self, slot: int, follower: Any, follow_rotation: bool = True) -> None:
+        """Link a component so its position (and rotation) track a synced body.
+
+        Args:
+            slot: Slot of the body to follow.
+            follower: Object with position (Vector2) and rotation (degrees) attributes.
+            follow_rotation: True to copy the body angle too.
+
+        Returns:
+            None
+        """
+        # Followers are written in place, so they must not share a Vector2.
+        x, y = self.positions[slot].tolist()
+        follower.position = v2(x, y)
+        if follow_rotation:
+            follower.rotation = float(self.angles[slot])
+        self.followers.append((slot, follower, follow_rotation))
+
+    def refresh_body(self, slot: int) -> None:
+        """Re-read one body into the cache and push it to its followers.
+
+        Call after teleporting or rotating a body outside the physics step.
+
+        Args:
+            slot: Slot of the body.
+
+        Returns:
+            None
+        """
+        component = self.synced[slot]
+        body = component.body if component else None
+        if body is None:
+            return
+        position = body.position
+        self.positions[slot, 0] = position.x * self.meters_to_pixels
+        self.positions[slot, 1] = position.y * self.meters_to_pixels
+        self.angles[slot] = math.degrees(body.angle)
+        x, y = self.positions[slot].tolist()
+        for follower_slot, follower, follow_rotation in self.followers:
+            if follower_slot == slot:
+                follower.position.x = x
+                follower.position.y = y
+                if follow_rotation:
+                    follower.rotation = float(self.angles[slot])
+
+    def sync_transforms(self) -> None:
+        """Copy moving body transforms into the cache and push them to followers.
+
+        pybox2d has no batched transform read, so the bodies are read in one
+        tight pass and the unit conversion and write into the cache are done in
+        bulk.
+
+        Returns:
+            None
+        """
+        slots = []
+        transforms = []
+        for slot, component in enumerate(self.synced):
+            body = component.body if component else None
+            if body is None or not body.awake or not body.active or body.type == b2_staticBody:
+                continue
+            position = body.position
+            slots.append(slot)
+            transforms.append((position.x, position.y, body.angle))
+        if slots:
+            moved = np.array(transforms, dtype=np.float64)
+            self.positions[slots] = moved[:, 0:2] * self.meters_to_pixels
+            self.angles[slots] = np.degrees(moved[:, 2])
+        self.push_followers()
+
+    def push_followers(self) -> None:
+        """Write cached transforms into every follower.
+
+        Returns:
+            None
+        """
+        if not self.followers:
+            return
+        positions = self.positions.tolist()
+        angles = self.angles.tolist()
+        for slot, follower, follow_rotation in self.followers:
+            position = follower.position
+            position.x, position.y = positions[slot]
+            if follow_rotation:
+                follower.rotation = angles[slot]
 
     def draw_debug(self) -> None:
         """Draw debug shapes for the physics world.
 
+        Call inside the camera's 2D mode. Static bodies are drawn from the cached
+        mesh; other bodies and joints are drawn live, skipping those outside the view.
+
+        Returns:
+            None
+        """
+        if not self.world:
+            return
+        min_x, min_y, max_x, max_y = get_view_bounds()
+        scale = self.pixels_to_meters
+        min_x, min_y, max_x, max_y = min_x * scale, min_y * scale, max_x * scale, max_y * scale
+        static_key = []
+        visible = []
+        for body in self.world.bodies:
+            x, y = body.position
+            if body.type == b2_staticBody:
+                static_key.append((x, y, body.angle))
+                continue
+            radius = 0.0
+            for fixture in body.fixtures:
+                shape = fixture.shape
+                if isinstance(shape, b2CircleShape):
+                    radius = max(radius, shape.pos.length + shape.radius)
+                else:
+                    radius = max(radius, max(math.hypot(vx, vy) for vx, vy in shape.vertices))
+            if x + radius >= min_x and x - radius <= max_x and y + radius >= min_y and y - radius <= max_y:
+                visible.append(body)
+
+        if self.debug_job and self.debug_job.is_cancelled:
+            # JobManager dropped the rebuild when the scene was exited; start it again.
+            self.debug_job = None
+            self.debug_static_key = None
+        if static_key != self.debug_static_key:
+            static_bodies = [body for body in self.world.bodies if body.type == b2_staticBody]
+            if self.jobs:
+                if self.debug_job:
+                    self.debug_job.cancel()
+                shapes = self.debug_draw.capture_static(static_bodies)
+                self.debug_job = self.jobs.submit(self.debug_draw.build_static_steps(shapes),
+                                                  name="physics debug mesh")
+            else:
+                self.debug_draw.build_static(static_bodies)
+            self.debug_static_key = static_key
+        self.debug_draw.draw_static()
+
+        for body in visible:
+            if not body.active:
+                color = INACTIVE_COLOR
+            elif body.type == b2_kinematicBody:
+                color = KINEMATIC_COLOR
+            elif not body.awake:
+                color = ASLEEP_COLOR
+            else:
+                color = AWAKE_COLOR
+            self.debug_draw.draw_body(body, color)
+        for joint in self.world.joints:
+            a, b = joint.anchorA, joint.anchorB
+            if (max(a[0], b[0]) >= min_x and min(a[0], b[0]) <= max_x
+                    and max(a[1], b[1]) >= min_y and min(a[1], b[1]) <= max_y):
+                self.debug_draw.DrawSegment(a, b, JOINT_COLOR)
+
+    def invalidate_debug_cache(self) -> None:
+        """Rebuild the static debug mesh on the next draw_debug.
+
         Returns:
             None
         """
-        if self.world:
-            self.world.DrawDebugData()
+        self.debug_static_key = None
 
     def convert_to_pixels(self, meters: b2Vec2) -> b2Vec2:
         """Convert meters to pixels.
@@ -287,6 +2008,339 @@ class PhysicsService(Service):
         return rectangle_hit(self.world, ignore_body, center_m, size_m, rotation)
 
 
+class TransformService(Service):
+    """Service that resolves TransformComponent world transforms once per frame.
+
+    Roots are transforms parented to a BodyComponent. Each frame the cached
+    transform of every root body is compared with the one it was last
+    resolved against, and only roots whose body moved, plus transforms whose
+    local values changed, are recomputed together with their subtrees. A
+    hierarchy under a sleeping, unmoved body costs nothing.
+
+    The root slot cache is rebuilt when roots are added or removed and
+    whenever PhysicsService assigns or frees a slot, so a root whose body
+    registers later or whose slot is reused never reads another body's row.
+    Roots whose body has no slot yet are skipped until it registers.
+
+    Changes made during object updates are applied before the scene draws.
+    Add it after PhysicsService so roots see the current step.
+
+    Attributes:
+        roots: Transforms parented to bodies.
+        dirty: Transforms changed since the last pass.
+    """
+    def __init__(self) -> None:
+        super().__init__()
+        self.physics: Optional[PhysicsService] = None
+        self.roots: List[Any] = []
+        self.dirty: List[Any] = []
+        self.root_indices = np.zeros(0, dtype=np.int64)
+        self.root_slots = np.zeros(0, dtype=np.int64)
+        self.root_transforms = np.zeros((0, 3), dtype=np.float64)
+        self.roots_changed = False
+        self.slots_version = -1
+
+    def init(self) -> None:
+        """Resolve PhysicsService.
+
+        Returns:
+            None
+        """
+        self.physics = self.scene.get_service(PhysicsService)
+
+    def add_root(self, transform: Any) -> None:
+        """Track a transform parented to a body.
+
+        Args:
+            transform: TransformComponent whose parent is a BodyComponent.
+
+        Returns:
+            None
+        """
+        self.roots.append(transform)
+        self.roots_changed = True
+        self.mark_dirty(transform)
+
+    def remove_root(self, transform: Any) -> None:
+        """Stop tracking a body-parented transform.
+
+        Args:
+            transform: Transform previously passed to add_root.
+
+        Returns:
+            None
+        """
+        if transform in self.roots:
+            self.roots.remove(transform)
+            self.roots_changed = True
+
+    def mark_dirty(self, transform: Any) -> None:
+        """Queue a transform whose local values or parent changed.
+
+        Args:
+            transform: TransformComponent to recompute with its subtree.
+
+        Returns:
+            None
+        """
+        transform.is_dirty = True
+        self.dirty.append(transform)
+
+    def update(self, delta_time: float) -> None:
+        """Recompute the subtrees of moved roots and changed transforms.
+
+        Args:
+            delta_time: Seconds since the last frame.
+
+        Returns:
+            None
+        """
+        if self.roots_changed or self.slots_version != self.physics.slots_version:
+            slots = np.array([root.parent.slot for root in self.roots], dtype=np.int64)
+            self.root_indices = np.flatnonzero(slots >= 0)
+            self.root_slots = slots[self.root_indices]
+            # NaN never compares equal, so every cached root is resolved once against its new slot.
+            self.root_transforms = np.full((len(self.root_slots), 3), np.nan)
+            self.slots_version = self.physics.slots_version
+            self.roots_changed = False
+        if len(self.root_slots):
+            current = np.column_stack((self.physics.positions[self.root_slots], self.physics.angles[self.root_slots]))
+            moved = np.flatnonzero((current != self.root_transforms).any(axis=1))
+            if len(moved):
+                self.root_transforms[moved] = current[moved]
+                for index in self.root_indices[moved].tolist():
+                    root = self.roots[index]
+                    root.is_dirty = True
+                    self.dirty.append(root)
+        self.flush()
+
+    def draw(self) -> None:
+        """Apply changes made during object updates before anything draws.
+
+        Returns:
+            None
+        """
+        self.flush()
+
+    def flush(self) -> None:
+        """Recompute every queued transform that is still dirty.
+
+        Returns:
+            None
+        """
+        if self.dirty:
+            dirty = self.dirty
+            self.dirty = []
+            for transform in dirty:
+                if transform.is_dirty:
+                    self.resolve(transform)
+
+    def resolve(self, transform: Any) -> None:
+        """Bring a transform up to date by recomputing its topmost dirty ancestor's subtree.
+
+        Args:
+            transform: TransformComponent to resolve.
+
+        Returns:
+            None
+        """
+        top = transform if transform.is_dirty else None
+        node = transform.parent
+        while node is not None and hasattr(node, "children"):
+            if node.is_dirty:
+                top = node
+            node = node.parent
+        if top is None:
+            return
+        stack = [top]
+        while stack:
+            node = stack.pop()
+            node.compute_world()
+            stack.extend(node.children)
+
+
+class SnapshotService(Service):
+    """Capture and restore scene state in a flat float64 buffer.
+
+    A snapshot holds, for every non-static body registered with PhysicsService,
+    its position, angle, linear and angular velocity, and awake/active flags,
+    followed by every registered gameplay field (health, timers, is_active of
+    pooled objects, ...). Capture fills a preallocated buffer; restore writes
+    everything back and refreshes PhysicsService's transform cache in bulk.
+
+    Box2D's contact cache is not part of the snapshot, so the first step after
+    a restore warm-starts from the current contacts rather than the captured
+    ones.
+
+    The layout is fixed by the bodies and fields registered when the first
+    snapshot is taken (or when build_layout is called). Register everything in
+    init and call build_layout again if the set changes. Fields are copied one
+    attribute name at a time across all objects that registered it, so
+    registering the same name on many objects (is_active of a pool) is cheap.
+    tools/bench_scenes.py times capture and restore for 500 bodies.
+    """
+    BODY_STRIDE = 8
+
+    def __init__(self) -> None:
+        """Create the service.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.physics: Optional[PhysicsService] = None
+        self.fields: List[Tuple[Any, str, type]] = []
+        self.body_slots: List[int] = []
+        self.bodies: List[b2Body] = []
+        self.field_groups: List[Tuple[str, type, Callable[[Any], Any], List[Any], np.ndarray]] = []
+        self.size = 0
+
+    def init(self) -> None:
+        """Resolve PhysicsService.
+
+        Returns:
+            None
+        """
+        self.physics = self.scene.get_service(PhysicsService)
+
+    def register_field(self, obj: Any, name: str) -> None:
+        """Include an attribute in snapshots. Its type is restored as it was at registration.
+
+        Args:
+            obj: Object owning the attribute.
+            name: Attribute name; the value must be a bool, int, or float.
+
+        Returns:
+            None
+        """
+        self.fields.append((obj, name, type(getattr(obj, name))))
+        self.size = 0
+
+    def register_fields(self, obj: Any, names: List[str]) -> None:
+        """Include several attributes of one object in snapshots.
+
+        Args:
+            obj: Object owning the attributes.
+            names: Attribute names.
+
+        Returns:
+            None
+        """
+        for name in names:
+            self.register_field(obj, name)
+
+    def build_layout(self) -> int:
+        """Fix the set of bodies and fields stored in a snapshot.
+
+        Returns:
+            Number of float64 values in a snapshot.
+        """
+        self.body_slots = []
+        self.bodies = []
+        for slot, component in enumerate(self.physics.synced):
+            body = component.body if component else None
+            if body is not None and body.type != b2_staticBody:
+                self.body_slots.append(slot)
+                self.bodies.append(body)
+        field_start = 2 + len(self.bodies) * self.BODY_STRIDE
+        groups: Dict[Tuple[str, type], Tuple[List[Any], List[int]]] = {}
+        for index, (obj, name, kind) in enumerate(self.fields):
+            objects, indices = groups.setdefault((name, kind), ([], []))
+            objects.append(obj)
+            indices.append(field_start + index)
+        self.field_groups = [(name, kind, attrgetter(name), objects, np.array(indices, dtype=np.int64))
+                             for (name, kind), (objects, indices) in groups.items()]
+        self.size = field_start + len(self.fields)
+        return self.size
+
+    def allocate(self) -> np.ndarray:
+        """Allocate a buffer for one snapshot.
+
+        Returns:
+            Zeroed float64 buffer.
+        """
+        if not self.size:
+            self.build_layout()
+        return np.zeros(self.size, dtype=np.float64)
+
+    def capture(self, buffer: Optional[np.ndarray] = None) -> np.ndarray:
+        """Capture the current state.
+
+        Args:
+            buffer: Buffer from allocate() to fill, or None to allocate one.
+
+        Returns:
+            The filled buffer.
+        """
+        if not self.size:
+            self.build_layout()
+        if buffer is None:
+            buffer = np.zeros(self.size, dtype=np.float64)
+        body_count = len(self.bodies)
+        buffer[0] = body_count
+        buffer[1] = len(self.fields)
+        if body_count:
+            rows = []
+            append = rows.append
+            for body in self.bodies:
+                position = body.position
+                velocity = body.linearVelocity
+                append((position.x, position.y, body.angle, velocity.x, velocity.y, body.angularVelocity,
+                        body.awake, body.active))
+            buffer[2:2 + body_count * self.BODY_STRIDE].reshape(body_count, self.BODY_STRIDE)[:] = rows
+        for _, _, getter, objects, indices in self.field_groups:
+            buffer[indices] = list(map(getter, objects))
+        return buffer
+
+    def checksum(self, buffer: np.ndarray) -> int:
+        """CRC32 of a captured state, for comparing two simulations of the same frame.
+
+        Args:
+            buffer: Buffer filled by capture.
+
+        Returns:
+            Checksum of the buffer's bytes.
+        """
+        return zlib.crc32(buffer.tobytes())
+
+    def restore(self, buffer: np.ndarray) -> None:
+        """Write a captured state back into the bodies, fields, and transform cache.
+
+        Args:
+            buffer: Buffer filled by capture.
+
+        Returns:
+            None
+
+        Raises:
+            ValueError: If the buffer was captured with a different layout.
+        """
+        body_count = len(self.bodies)
+        if int(buffer[0]) != body_count or int(buffer[1]) != len(self.fields):
+            raise ValueError("Snapshot layout does not match the registered bodies and fields")
+        end = 2 + body_count * self.BODY_STRIDE
+        bodies = buffer[2:end].reshape(body_count, self.BODY_STRIDE)
+        for body, (x, y, angle, vx, vy, spin, awake, active) in zip(self.bodies, bodies.tolist()):
+            if body.active != bool(active):
+                body.active = bool(active)
+            # The position and angle setters each call SetTransform (and re-sync the fixtures); call it once.
+            body.SetTransform((x, y), angle)
+            body.linearVelocity = (vx, vy)
+            body.angularVelocity = spin
+            if body.awake != bool(awake):
+                body.awake = bool(awake)
+
+        for name, kind, _, objects, indices in self.field_groups:
+            for obj, value in zip(objects, map(kind, buffer[indices].tolist())):
+                setattr(obj, name, value)
+
+        if body_count:
+            physics = self.physics
+            physics.positions[self.body_slots] = bodies[:, 0:2] * physics.meters_to_pixels
+            physics.angles[self.body_slots] = np.degrees(bodies[:, 2])
+            physics.push_followers()
+
+
 @dataclass(frozen=True)
 class IntPoint:
     x: int
@@ -342,12 +2396,17 @@ class LayerRenderer:
 class LevelService(Service):
     """Service for loading and drawing LDtk levels and collisions.
 
+    If the game has a WorkerManager, collision outlines are traced on worker
+    threads while tile layers render on the main thread; the Box2D fixtures
+    are then created on the main thread.
+
     Attributes:
         project: Parsed LDtk project.
         level: Active Level instance.
         renderers: Render textures per layer.
         layer_bodies: Physics bodies used for collision.
         physics: PhysicsService reference.
+        collision_grids: Solid cells and cell size in pixels per collision layer.
     """
     def __init__(self,
                  project_file: str,
@@ -365,6 +2424,7 @@ class LevelService(Service):
         self.layer_bodies: List[b2Body] = []
         self.physics: Optional[PhysicsService] = None
         self.layer_defs_by_uid: Dict[int, Any] = {}
+        self.collision_grids: List[Tuple[np.ndarray, float]] = []
 
     def init(self) -> None:
         """Load the LDtk project, build renderers and collision bodies.
@@ -403,17 +2463,32 @@ class LevelService(Service):
             print("PhysicsService required for LevelService")
             raise RuntimeError("PhysicsService required")
 
+        layers = self.level.layer_instances or []
+        collision_layers = [layer for layer in layers if layer.type == "IntGrid" and self.collision_names]
+        masks = [self._collision_mask(layer) for layer in collision_layers]
+        game = self.scene.game
+        workers = game.get_manager(WorkerManager) if game.has_manager(WorkerManager) else None
+        if workers:
+            traced = [workers.submit(self.trace_collision_loops, mask) for mask in masks]
+
         texture_service = self.scene.get_service(TextureService)
-        for layer in self.level.layer_instances or []:
-            if layer.tileset_rel_path:
+        for layer in layers:
+            if layer.tileset_rel_path and not game.headless:
                 tileset_path = self._resolve_tileset_path(layer.tileset_rel_path)
                 texture = texture_service.get_texture(tileset_path)
                 renderer = rl.load_render_texture(self.level.px_wid, self.level.px_hei)
                 self._render_layer_tiles(layer, texture, renderer)
                 self.renderers.append(LayerRenderer(renderer=renderer, layer_iid=layer.iid, visible=layer.visible))
 
-            if layer.type == "IntGrid" and self.collision_names:
-                self._build_collision_for_layer(layer)
+        if workers:
+            layer_loops = workers.wait(traced)
+        else:
+            layer_loops = [self.trace_collision_loops(mask) for mask in masks]
+        for layer, loops in zip(collision_layers, layer_loops):
+            self._build_collision_for_layer(layer, loops)
+        for layer, mask in zip(collision_layers, masks):
+            grid = np.array(mask, dtype=np.bool_)[1:-1, 1:-1]
+            self.collision_grids.append((grid, float(layer.grid_size) * self.scale))
 
     def _resolve_tileset_path(self, rel_path: str) -> str:
         """Resolve a tileset path relative to the project file.
@@ -454,7 +2529,7 @@ class LevelService(Service):
         Returns:
             None
         """
-        rl.begin_texture_mode(renderer)
+        render.begin_texture_mode(renderer)
         rl.clear_background(rl.Color(0, 0, 0, 0))
 
         tile_size = layer.grid_size
@@ -467,9 +2542,9 @@ class LevelService(Service):
                             float(tile_size) * (-1.0 if flip_x else 1.0),
                             float(tile_size) * (-1.0 if flip_y else 1.0))
             dest = v2(float(tile.px[0] + layer.px_total_offset_x), float(tile.px[1] + layer.px_total_offset_y))
-            rl.draw_texture_rec(texture, src, dest, rl.WHITE)
+            render.draw_texture_rec(texture, src, dest, rl.WHITE)
 
-        rl.end_texture_mode()
+        render.end_texture_mode()
 
     def _intgrid_value_name(self, layer: LayerInstance, value: int) -> Optional[str]:
         """Map an IntGrid value to its identifier string.
@@ -491,31 +2566,47 @@ class LevelService(Service):
                 return def_value.identifier
         return None
 
-    def _build_collision_for_layer(self, layer: LayerInstance) -> None:
-        """Create boundary colliders for a collision layer.
+    def _collision_mask(self, layer: LayerInstance) -> List[List[bool]]:
+        """Mark the cells of an IntGrid layer whose value is a collision name.
 
         Args:
-            layer: Layer instance to build colliders for.
+            layer: IntGrid layer instance.
 
         Returns:
-            None
+            Rows of solid flags with a one-cell empty border, so neighbors never go out of range.
         """
-        if not self.physics or not self.physics.world:
-            return
-        world = self.physics.world
-        body = world.CreateStaticBody(position=(0, 0))
         grid_w = layer.c_wid
         grid_h = layer.c_hei
-        cell_size = float(layer.grid_size) * self.scale
-        # Build boundary edges into chain shapes to avoid internal collisions.
+        solid_values = {value for value in set(layer.int_grid_csv)
+                        if self._intgrid_value_name(layer, value) in self.collision_names}
+        values = list(layer.int_grid_csv[:grid_w * grid_h])
+        values += [0] * (grid_w * grid_h - len(values))
+        border = [False] * (grid_w + 2)
+        mask = [border]
+        for y in range(grid_h):
+            mask.append([False] + [value in solid_values for value in values[y * grid_w:(y + 1) * grid_w]] + [False])
+        mask.append(border)
+        return mask
+
+    @staticmethod
+    def trace_collision_loops(mask: List[List[bool]]) -> List[List[tuple]]:
+        """Trace the outlines of solid cells into closed loops of grid corners.
+
+        Pure Python with no raylib or Box2D calls, so it can run on a worker thread.
+
+        Args:
+            mask: Solid flags from _collision_mask.
+
+        Returns:
+            Loops of (x, y) cell corner coordinates.
+        """
+        grid_h = len(mask) - 2
+        grid_w = len(mask[0]) - 2
+
         def is_solid(cx: int, cy: int) -> bool:
-            if cx < 0 or cy < 0 or cx >= grid_w or cy >= grid_h:
-                return False
-            idx = cy * grid_w + cx
-            value = layer.int_grid_csv[idx] if idx < len(layer.int_grid_csv) else 0
-            name = self._intgrid_value_name(layer, value)
-            return bool(name and name in self.collision_names)
+            return mask[cy + 1][cx + 1]
 
+        # Build boundary edges into chain shapes to avoid internal collisions.
         def make_edge(a, b):
             return (a, b) if a <= b else (b, a)
 
@@ -570,7 +2661,23 @@ class LevelService(Service):
                 poly.pop()
             if len(poly) >= 3:
                 loops.append(poly)
+        return loops
+
+    def _build_collision_for_layer(self, layer: LayerInstance, loops: List[List[tuple]]) -> None:
+        """Create boundary colliders for a collision layer.
+
+        Args:
+            layer: Layer instance to build colliders for.
+            loops: Outlines from trace_collision_loops.
 
+        Returns:
+            None
+        """
+        if not self.physics or not self.physics.world:
+            return
+        world = self.physics.world
+        body = world.CreateStaticBody(position=(0, 0))
+        cell_size = float(layer.grid_size) * self.scale
         for loop in loops:
             verts = []
             for cx, cy in loop:
@@ -587,6 +2694,18 @@ class LevelService(Service):
                 body.CreateFixture(shape=edge, friction=0.1, restitution=0.1)
         self.layer_bodies.append(body)
 
+    def unload(self) -> None:
+        """Unload the layer render textures and forget the collision bodies (PhysicsService owns the world).
+
+        Returns:
+            None
+        """
+        for renderer in self.renderers:
+            rl.unload_render_texture(renderer.renderer)
+        self.renderers.clear()
+        self.layer_bodies.clear()
+        self.collision_grids.clear()
+
     def draw(self) -> None:
         """Draw all visible layer renderers in reverse order.
 
@@ -599,7 +2718,7 @@ class LevelService(Service):
             texture = renderer.renderer.texture
             src = rl.Rectangle(0.0, 0.0, float(texture.width), -float(texture.height))
             dest = rl.Rectangle(0.0, 0.0, float(texture.width) * self.scale, float(texture.height) * self.scale)
-            rl.draw_texture_pro(texture, src, dest, v2(0.0, 0.0), 0.0, rl.WHITE)
+            render.draw_texture_pro(texture, src, dest, v2(0.0, 0.0), 0.0, rl.WHITE)
 
     def draw_layer(self, layer_id_or_name: str) -> None:
         """Draw a specific layer by IID or identifier.
@@ -624,7 +2743,7 @@ class LevelService(Service):
                 texture = renderer.renderer.texture
                 src = rl.Rectangle(0.0, 0.0, float(texture.width), -float(texture.height))
                 dest = rl.Rectangle(0.0, 0.0, float(texture.width) * self.scale, float(texture.height) * self.scale)
-                rl.draw_texture_pro(texture, src, dest, v2(0.0, 0.0), 0.0, rl.WHITE)
+                render.draw_texture_pro(texture, src, dest, v2(0.0, 0.0), 0.0, rl.WHITE)
                 return
 
     def set_layer_visibility(self, layer_id_or_name: str, visible: bool) -> None:
@@ -646,6 +2765,14 @@ class LevelService(Service):
                         renderer.visible = visible
                         return
 
+    def get_collision_grid(self) -> Optional[Tuple[np.ndarray, float]]:
+        """Get the solid cells of the first collision layer.
+
+        Returns:
+            (rows x columns bool array, cell size in pixels), or None without collision layers.
+        """
+        return self.collision_grids[0] if self.collision_grids else None
+
     def get_layer_by_name(self, name: str) -> Optional[LayerInstance]:
         """Get a layer instance by name.
 
@@ -3,8 +3,9 @@ from __future__ import annotations
 from dataclasses import dataclass
 from typing import List, Optional
 
-from Box2D import (b2AABB, b2Body, b2CircleShape, b2PolygonShape, b2QueryCallback,
-                   b2RayCastCallback, b2Transform, b2Vec2, b2TestOverlap)
+from Box2D import (b2AABB, b2Body, b2CircleShape, b2Distance, b2PolygonShape, b2QueryCallback,
+                   b2RayCastCallback, b2Sweep, b2TimeOfImpact, b2Transform, b2Vec2, b2TestOverlap,
+                   b2_staticBody)
 
 
 @dataclass
@@ -27,6 +28,27 @@ class RayHit:
     normal: b2Vec2 = b2Vec2(0.0, 0.0)
 
 
+# b2TOIOutput states returned by b2TimeOfImpact.
+_TOI_OVERLAPPED = 2
+_TOI_TOUCHING = 3
+
+
+@dataclass
+class ShapeHit:
+    """Shape cast hit data.
+
+    Attributes:
+        hit: True if the shape hit something.
+        body: The body hit, if any.
+        fraction: Fraction of the translation that can be travelled before touching.
+        normal: World-space surface normal, pointing back toward the cast shape.
+    """
+    hit: bool = False
+    body: Optional[b2Body] = None
+    fraction: float = 1.0
+    normal: b2Vec2 = b2Vec2(0.0, 0.0)
+
+
 class _RayCastClosest(b2RayCastCallback):
     def __init__(self, ignore_body: Optional[b2Body], translation: b2Vec2, result: RayHit) -> None:
         super().__init__()
@@ -187,3 +209,85 @@ def rectangle_hit(world, ignore_body: Optional[b2Body], center: b2Vec2, size: b2
     transform.position = center
     transform.angle = rotation
     return shape_hit(world, ignore_body, shape, transform)
+
+
+def shape_cast(world, ignore_body: Optional[b2Body], shape, position: b2Vec2, translation: b2Vec2,
+               static_only: bool = True) -> ShapeHit:
+    """Sweep a shape along a translation and return the first time of impact.
+
+    Candidates come from one AABB query over the swept bounds, then each is
+    tested with Box2D's time of impact. Surfaces the shape is already touching
+    but moving away from are ignored, so a resting shape can always leave them.
+
+    Args:
+        world: Box2D world to query.
+        ignore_body: Optional body to ignore.
+        shape: Box2D shape to sweep, in local coordinates (no rotation).
+        position: Start position of the shape in world units.
+        translation: Sweep delta in world units.
+        static_only: If True, only static bodies block the sweep.
+
+    Returns:
+        ShapeHit for the closest blocking surface (or empty hit if none).
+    """
+    result = ShapeHit()
+    if translation.length <= 1e-9:
+        return result
+    end = b2Vec2(position.x + translation.x, position.y + translation.y)
+    start_transform = b2Transform()
+    start_transform.position = position
+    start_transform.angle = 0.0
+    end_transform = b2Transform()
+    end_transform.position = end
+    end_transform.angle = 0.0
+    start_box = shape.getAABB(start_transform, 0)
+    end_box = shape.getAABB(end_transform, 0)
+    aabb = b2AABB(lowerBound=b2Vec2(min(start_box.lowerBound.x, end_box.lowerBound.x),
+                                    min(start_box.lowerBound.y, end_box.lowerBound.y)),
+                  upperBound=b2Vec2(max(start_box.upperBound.x, end_box.upperBound.x),
+                                    max(start_box.upperBound.y, end_box.upperBound.y)))
+    candidates = []
+
+    class _QueryCallback(b2QueryCallback):
+        def ReportFixture(self, fixture):  # noqa: N802
+            body = fixture.body
+            if ignore_body is not None and body == ignore_body:
+                return True
+            if fixture.sensor or (static_only and body.type != b2_staticBody):
+                return True
+            candidates.append(fixture)
+            return True
+
+    world.QueryAABB(_QueryCallback(), aabb)
+    if not candidates:
+        return result
+
+    sweep_a = b2Sweep(localCenter=(0.0, 0.0), c0=position, c=end, a0=0.0, a=0.0)
+    for fixture in candidates:
+        body = fixture.body
+        center = body.worldCenter
+        sweep_b = b2Sweep(localCenter=body.localCenter, c0=center, c=center, a0=body.angle, a=body.angle)
+        for child in range(fixture.shape.childCount):
+            state, fraction = b2TimeOfImpact(shapeA=shape, idxA=0, shapeB=fixture.shape, idxB=child,
+                                             sweepA=sweep_a, sweepB=sweep_b, tMax=1.0)
+            if fraction >= result.fraction or state not in (_TOI_OVERLAPPED, _TOI_TOUCHING):
+                continue
+            hit_transform = b2Transform()
+            hit_transform.position = b2Vec2(position.x + translation.x * fraction,
+                                            position.y + translation.y * fraction)
+            hit_transform.angle = 0.0
+            distance = b2Distance(shapeA=shape, idxA=0, shapeB=fixture.shape, idxB=child,
+                                  transformA=hit_transform, transformB=body.transform, useRadii=False)
+            normal = b2Vec2(distance.pointA.x - distance.pointB.x, distance.pointA.y - distance.pointB.y)
+            length = normal.length
+            if length > 1e-6:
+                normal = b2Vec2(normal.x / length, normal.y / length)
+            else:
+                normal = b2Vec2(-translation.x / translation.length, -translation.y / translation.length)
+            if normal.x * translation.x + normal.y * translation.y >= 0.0:
+                continue
+            result.hit = True
+            result.body = body
+            result.fraction = fraction
+            result.normal = normal
+    return result
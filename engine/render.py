@@ -0,0 +1,573 @@
+"""Instrumented raylib drawing.
+
+Engine and sample draw paths call these wrappers instead of the raylib
+functions of the same name. With stats.enabled, every call is also counted
+per frame, per camera, and per owner (the Scene, Service, GameObject,
+Component, or Manager type that is drawing, set by the framework):
+
+    draws             shapes, textures, text, and meshes drawn
+    draw_calls        GPU draw calls
+    batch_flushes     render batches submitted
+    texture_switches  draw calls binding a different texture than the last one
+    target_switches   begin_texture_mode and end_texture_mode
+    blend_changes     blend mode changes
+
+raylib does not report its draw calls, so they are derived by following
+rlgl's batching rules: a draw call starts whenever the texture or the
+primitive mode changes, and the batch is flushed on mode, render target, and
+blend changes, when it runs out of vertices or draw calls, and at
+end_drawing. Counts are an estimate of rlgl's work, not a GPU measurement.
+
+stats.last holds the counts of the last finished frame:
+
+    {"totals": {counter: n}, "cameras": {label: {counter: n}}, "owners": {name: {counter: n}}}
+
+Cameras are labelled by type and order of drawing in the frame
+("SplitCamera 0"); draws outside a camera go to "screen".
+"""
+
+from __future__ import annotations
+
+from typing import Any, Dict, List, Optional, Tuple
+
+import pyray as rl
+
+COUNTERS = ("draws", "draw_calls", "batch_flushes", "texture_switches", "target_switches", "blend_changes")
+DRAWS, DRAW_CALLS, BATCH_FLUSHES, TEXTURE_SWITCHES, TARGET_SWITCHES, BLEND_CHANGES = range(len(COUNTERS))
+
+SCREEN = "screen"
+
+# rlgl primitive modes and default batch limits (RL_DEFAULT_BATCH_BUFFER_ELEMENTS quads,
+# RL_DEFAULT_BATCH_DRAWCALLS).
+LINES, TRIANGLES, QUADS = range(3)
+BATCH_VERTICES = 8192 * 4
+BATCH_DRAW_CALLS = 256
+
+# Texture keys for draws that do not pass a texture.
+SHAPES_TEXTURE = -1
+DEFAULT_FONT_TEXTURE = -2
+
+
+class RenderStats:
+    """Per-frame draw counters and a model of rlgl's render batch.
+
+    Attributes:
+        enabled: Count draws. The wrappers only forward to raylib while False.
+        owner: Type (or name) that draws are attributed to.
+        camera: Label that draws are attributed to.
+        totals: Counts of the current frame, indexed like COUNTERS.
+        cameras: Counts of the current frame per camera label.
+        owners: Counts of the current frame per owner.
+        last: Snapshot of the last finished frame.
+    """
+    def __init__(self) -> None:
+        """Create disabled, empty counters.
+
+        Returns:
+            None
+        """
+        self.enabled = False
+        self.owner: Any = None
+        self.camera = SCREEN
+        self.camera_count = 0
+        self.totals: List[int] = [0] * len(COUNTERS)
+        self.cameras: Dict[str, List[int]] = {}
+        self.owners: Dict[Any, List[int]] = {}
+        self.last: Dict[str, Any] = {}
+        self.batch_key: Optional[Tuple[int, int]] = None
+        self.batch_vertices = 0
+        self.batch_draw_calls = 0
+        self.bound_texture: Optional[int] = None
+        self.blend_mode = rl.BLEND_ALPHA
+
+    def begin_frame(self) -> None:
+        """Reset the counters and the batch model for a new frame.
+
+        Returns:
+            None
+        """
+        self.owner = None
+        self.camera = SCREEN
+        self.camera_count = 0
+        self.totals = [0] * len(COUNTERS)
+        self.cameras = {}
+        self.owners = {}
+        self.batch_key = None
+        self.batch_vertices = 0
+        self.batch_draw_calls = 0
+        self.bound_texture = None
+        self.blend_mode = rl.BLEND_ALPHA
+
+    def end_frame(self) -> None:
+        """Flush the batch, as end_drawing does, and store the frame in last.
+
+        Returns:
+            None
+        """
+        self.flush()
+        self.last = {
+            "totals": dict(zip(COUNTERS, self.totals)),
+            "cameras": {label: dict(zip(COUNTERS, counts)) for label, counts in self.cameras.items()},
+            "owners": {_owner_name(owner): dict(zip(COUNTERS, counts)) for owner, counts in self.owners.items()},
+        }
+
+    def add(self, counter: int, amount: int = 1) -> None:
+        """Add to a counter of the frame, the current camera, and the current owner.
+
+        Args:
+            counter: Index into COUNTERS.
+            amount: Amount to add.
+
+        Returns:
+            None
+        """
+        self.totals[counter] += amount
+        camera = self.cameras.get(self.camera)
+        if camera is None:
+            camera = self.cameras[self.camera] = [0] * len(COUNTERS)
+        camera[counter] += amount
+        owner = self.owners.get(self.owner)
+        if owner is None:
+            owner = self.owners[self.owner] = [0] * len(COUNTERS)
+        owner[counter] += amount
+
+    def record_draw(self, texture: int, mode: int, vertices: int) -> None:
+        """Count a batched draw.
+
+        Args:
+            texture: Texture id (or SHAPES_TEXTURE / DEFAULT_FONT_TEXTURE).
+            mode: LINES, TRIANGLES, or QUADS.
+            vertices: Vertices the draw adds to the batch.
+
+        Returns:
+            None
+        """
+        if self.batch_key is not None and self.batch_vertices + vertices > BATCH_VERTICES:
+            self.flush()
+        key = (texture, mode)
+        if key != self.batch_key:
+            if self.batch_draw_calls >= BATCH_DRAW_CALLS:
+                self.flush()
+            self.batch_key = key
+            self.batch_draw_calls += 1
+            self.add(DRAW_CALLS)
+            if texture != self.bound_texture:
+                self.bound_texture = texture
+                self.add(TEXTURE_SWITCHES)
+        self.batch_vertices += vertices
+        self.add(DRAWS)
+
+    def record_mesh(self) -> None:
+        """Count a mesh drawn outside the batch with the default material.
+
+        Returns:
+            None
+        """
+        self.add(DRAWS)
+        self.add(DRAW_CALLS)
+        if self.bound_texture != SHAPES_TEXTURE:
+            self.bound_texture = SHAPES_TEXTURE
+            self.add(TEXTURE_SWITCHES)
+
+    def flush(self) -> None:
+        """Count a flush if the batch has pending draws.
+
+        Returns:
+            None
+        """
+        if self.batch_key is None:
+            return
+        self.add(BATCH_FLUSHES)
+        self.batch_key = None
+        self.batch_vertices = 0
+        self.batch_draw_calls = 0
+
+    def begin_camera(self, camera: Any) -> None:
+        """Attribute the following draws to a camera.
+
+        Args:
+            camera: Camera object; labelled by its type and drawing order in the frame.
+
+        Returns:
+            None
+        """
+        self.camera = f"{type(camera).__name__} {self.camera_count}"
+        self.camera_count += 1
+
+    def end_camera(self) -> None:
+        """Attribute the following draws to the screen again.
+
+        Returns:
+            None
+        """
+        self.camera = SCREEN
+
+
+def _owner_name(owner: Any) -> str:
+    """Name an owner for stats.last.
+
+    Args:
+        owner: Type, name, or None.
+
+    Returns:
+        Type name, the string itself, or "other" for None.
+    """
+    if owner is None:
+        return "other"
+    return owner.__name__ if isinstance(owner, type) else str(owner)
+
+
+stats = RenderStats()
+
+
+def begin_drawing() -> None:
+    """Start a frame: reset the counters, then rl.begin_drawing.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.begin_frame()
+    rl.begin_drawing()
+
+
+def end_drawing() -> None:
+    """End a frame: store its counts in stats.last, then rl.end_drawing.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.end_frame()
+    rl.end_drawing()
+
+
+def begin_texture_mode(target: rl.RenderTexture) -> None:
+    """Render into a texture (flushes the batch, counts a target switch).
+
+    Args:
+        target: Render texture to draw into.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.flush()
+        stats.add(TARGET_SWITCHES)
+    rl.begin_texture_mode(target)
+
+
+def end_texture_mode() -> None:
+    """Render to the screen again (flushes the batch, counts a target switch).
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.flush()
+        stats.add(TARGET_SWITCHES)
+    rl.end_texture_mode()
+
+
+def begin_mode_2d(camera: rl.Camera2D) -> None:
+    """Start drawing through a 2D camera (flushes the batch).
+
+    Args:
+        camera: Camera to draw through.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.flush()
+    rl.begin_mode_2d(camera)
+
+
+def end_mode_2d() -> None:
+    """Stop drawing through the 2D camera (flushes the batch).
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.flush()
+    rl.end_mode_2d()
+
+
+def set_blend_mode(mode: int) -> None:
+    """Set the rlgl blend mode (flushes the batch and counts a change if it differs).
+
+    Args:
+        mode: rl.BLEND_* mode.
+
+    Returns:
+        None
+    """
+    if stats.enabled and mode != stats.blend_mode:
+        stats.flush()
+        stats.add(BLEND_CHANGES)
+        stats.blend_mode = mode
+    rl.rl_set_blend_mode(mode)
+
+
+def set_blend_factors(source: int, destination: int, equation: int) -> None:
+    """Set the factors used by rl.BLEND_CUSTOM.
+
+    Args:
+        source: Source factor (GL enum).
+        destination: Destination factor (GL enum).
+        equation: Blend equation (GL enum).
+
+    Returns:
+        None
+    """
+    rl.rl_set_blend_factors(source, destination, equation)
+
+
+def draw_render_batch_active() -> None:
+    """Submit the pending render batch.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.flush()
+    rl.rl_draw_render_batch_active()
+
+
+def draw_mesh(mesh: rl.Mesh, material: rl.Material, transform: rl.Matrix) -> None:
+    """Draw a mesh immediately with a material (one draw call outside the batch).
+
+    Args:
+        mesh: Uploaded mesh.
+        material: Material to draw with.
+        transform: Model transform.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_mesh()
+    rl.draw_mesh(mesh, material, transform)
+
+
+def draw_texture(texture: rl.Texture, x: int, y: int, tint: rl.Color) -> None:
+    """Draw a texture at a position.
+
+    Args:
+        texture: Texture to draw.
+        x: Left in pixels.
+        y: Top in pixels.
+        tint: Tint color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(texture.id, QUADS, 4)
+    rl.draw_texture(texture, x, y, tint)
+
+
+def draw_texture_rec(texture: rl.Texture, source: rl.Rectangle, position: rl.Vector2, tint: rl.Color) -> None:
+    """Draw part of a texture at a position.
+
+    Args:
+        texture: Texture to draw.
+        source: Region of the texture.
+        position: Top-left in pixels.
+        tint: Tint color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(texture.id, QUADS, 4)
+    rl.draw_texture_rec(texture, source, position, tint)
+
+
+def draw_texture_pro(texture: rl.Texture, source: rl.Rectangle, dest: rl.Rectangle, origin: rl.Vector2,
+                     rotation: float, tint: rl.Color) -> None:
+    """Draw part of a texture into a rotated destination rectangle.
+
+    Args:
+        texture: Texture to draw.
+        source: Region of the texture.
+        dest: Destination rectangle.
+        origin: Rotation origin, relative to dest.
+        rotation: Degrees.
+        tint: Tint color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(texture.id, QUADS, 4)
+    rl.draw_texture_pro(texture, source, dest, origin, rotation, tint)
+
+
+def draw_text(text: str, x: int, y: int, font_size: int, color: rl.Color) -> None:
+    """Draw text with the default font.
+
+    Args:
+        text: Text to draw.
+        x: Left in pixels.
+        y: Top in pixels.
+        font_size: Height in pixels.
+        color: Text color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(DEFAULT_FONT_TEXTURE, QUADS, 4 * _glyph_count(text))
+    rl.draw_text(text, x, y, font_size, color)
+
+
+def draw_text_ex(font: rl.Font, text: str, position: rl.Vector2, font_size: float, spacing: float,
+                 tint: rl.Color) -> None:
+    """Draw text with a font.
+
+    Args:
+        font: Font to draw with.
+        text: Text to draw.
+        position: Top-left in pixels.
+        font_size: Height in pixels.
+        spacing: Extra space between glyphs.
+        tint: Text color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(font.texture.id, QUADS, 4 * _glyph_count(text))
+    rl.draw_text_ex(font, text, position, font_size, spacing, tint)
+
+
+def draw_rectangle(x: int, y: int, width: int, height: int, color: rl.Color) -> None:
+    """Draw a filled rectangle.
+
+    Args:
+        x: Left in pixels.
+        y: Top in pixels.
+        width: Width in pixels.
+        height: Height in pixels.
+        color: Fill color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, QUADS, 4)
+    rl.draw_rectangle(x, y, width, height, color)
+
+
+def draw_rectangle_pro(rec: rl.Rectangle, origin: rl.Vector2, rotation: float, color: rl.Color) -> None:
+    """Draw a filled, rotated rectangle.
+
+    Args:
+        rec: Rectangle.
+        origin: Rotation origin, relative to rec.
+        rotation: Degrees.
+        color: Fill color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, QUADS, 4)
+    rl.draw_rectangle_pro(rec, origin, rotation, color)
+
+
+def draw_rectangle_lines_ex(rec: rl.Rectangle, line_thick: float, color: rl.Color) -> None:
+    """Draw a rectangle outline.
+
+    Args:
+        rec: Rectangle.
+        line_thick: Outline width.
+        color: Outline color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, QUADS, 16)
+    rl.draw_rectangle_lines_ex(rec, line_thick, color)
+
+
+def draw_line_ex(start: rl.Vector2, end: rl.Vector2, thick: float, color: rl.Color) -> None:
+    """Draw a thick line.
+
+    Args:
+        start: Start point.
+        end: End point.
+        thick: Line width.
+        color: Line color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, TRIANGLES, 6)
+    rl.draw_line_ex(start, end, thick, color)
+
+
+def draw_triangle(v1: rl.Vector2, v2: rl.Vector2, v3: rl.Vector2, color: rl.Color) -> None:
+    """Draw a filled triangle.
+
+    Args:
+        v1: First corner.
+        v2: Second corner.
+        v3: Third corner.
+        color: Fill color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, QUADS, 4)
+    rl.draw_triangle(v1, v2, v3, color)
+
+
+def draw_circle_v(center: rl.Vector2, radius: float, color: rl.Color) -> None:
+    """Draw a filled circle.
+
+    Args:
+        center: Center.
+        radius: Radius.
+        color: Fill color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, QUADS, 72)
+    rl.draw_circle_v(center, radius, color)
+
+
+def draw_circle_lines(x: int, y: int, radius: float, color: rl.Color) -> None:
+    """Draw a circle outline.
+
+    Args:
+        x: Center x in pixels.
+        y: Center y in pixels.
+        radius: Radius.
+        color: Outline color.
+
+    Returns:
+        None
+    """
+    if stats.enabled:
+        stats.record_draw(SHAPES_TEXTURE, LINES, 72)
+    rl.draw_circle_lines(x, y, radius, color)
+
+
+def _glyph_count(text: str) -> int:
+    """Count the glyph quads text draws (whitespace draws nothing).
+
+    Args:
+        text: Text to draw.
+
+    Returns:
+        Number of glyphs.
+    """
+    return len(text) - text.count(" ") - text.count("\n")
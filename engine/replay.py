@@ -0,0 +1,142 @@
+from __future__ import annotations
+
+import struct
+from typing import BinaryIO, List, Optional, Tuple
+
+# File layout: header, then one record per frame.
+#   header: magic, version, player count, action count, random seed
+#   frame:  delta_time (float32), then one int8 per player per action
+_MAGIC = b"GJKR"
+_VERSION = 1
+_HEADER = struct.Struct("<4sHBBI")
+_DELTA = struct.Struct("<f")
+_SCALE = 127.0
+
+
+def quantize(frame: List[List[float]]) -> List[List[float]]:
+    """Round action values to the precision stored in a log.
+
+    Recording feeds the rounded values to the game too, so a replay sees
+    exactly the input the recorded session saw.
+
+    Args:
+        frame: Action values per player.
+
+    Returns:
+        Rounded action values per player.
+    """
+    return [[round(max(-1.0, min(1.0, value)) * _SCALE) / _SCALE for value in values] for values in frame]
+
+
+def quantize_delta_time(delta_time: float) -> float:
+    """Round a delta time to the float32 precision stored in a log.
+
+    Args:
+        delta_time: Delta time in seconds.
+
+    Returns:
+        The delta time a replay of this frame will use.
+    """
+    return _DELTA.unpack(_DELTA.pack(delta_time))[0]
+
+
+class InputRecorder:
+    """Write per-frame action state and delta time to a compact binary log."""
+    def __init__(self, filename: str, player_count: int, action_count: int, seed: int) -> None:
+        """Create the log and write its header.
+
+        Args:
+            filename: Output path.
+            player_count: Players per frame.
+            action_count: Actions per player.
+            seed: Random seed the session was started with.
+
+        Returns:
+            None
+        """
+        self.player_count = player_count
+        self.action_count = action_count
+        self.frame = struct.Struct(f"<{player_count * action_count}b")
+        self.file: Optional[BinaryIO] = open(filename, "wb")
+        self.file.write(_HEADER.pack(_MAGIC, _VERSION, player_count, action_count, seed & 0xFFFFFFFF))
+        self.frames = 0
+
+    def write_frame(self, delta_time: float, frame: List[List[float]]) -> None:
+        """Append one frame.
+
+        Args:
+            delta_time: Delta time the frame was simulated with.
+            frame: Quantized action values per player.
+
+        Returns:
+            None
+        """
+        if not self.file:
+            return
+        packed = [int(round(value * _SCALE)) for values in frame for value in values]
+        self.file.write(_DELTA.pack(delta_time))
+        self.file.write(self.frame.pack(*packed))
+        self.frames += 1
+
+    def close(self) -> None:
+        """Flush and close the log.
+
+        Returns:
+            None
+        """
+        if self.file:
+            self.file.close()
+            self.file = None
+
+
+class InputReplay:
+    """Read a log written by InputRecorder, one frame at a time."""
+    def __init__(self, filename: str) -> None:
+        """Open the log and read its header.
+
+        Args:
+            filename: Log path.
+
+        Returns:
+            None
+
+        Raises:
+            ValueError: If the file is not an input log of a supported version.
+        """
+        with open(filename, "rb") as handle:
+            self.data = handle.read()
+        if len(self.data) < _HEADER.size:
+            raise ValueError(f"Not an input log: {filename}")
+        magic, version, self.player_count, self.action_count, self.seed = _HEADER.unpack_from(self.data, 0)
+        if magic != _MAGIC or version != _VERSION:
+            raise ValueError(f"Unsupported input log: {filename}")
+        self.frame = struct.Struct(f"<{self.player_count * self.action_count}b")
+        self.record_size = _DELTA.size + self.frame.size
+        self.offset = _HEADER.size
+        self.frames = (len(self.data) - _HEADER.size) // self.record_size
+        self.frame_index = 0
+
+    def read_frame(self) -> Optional[Tuple[float, List[List[float]]]]:
+        """Read the next frame.
+
+        Returns:
+            (delta_time, action values per player), or None at the end of the log.
+        """
+        if self.frame_index >= self.frames:
+            return None
+        (delta_time,) = _DELTA.unpack_from(self.data, self.offset)
+        packed = self.frame.unpack_from(self.data, self.offset + _DELTA.size)
+        self.offset += self.record_size
+        self.frame_index += 1
+        count = self.action_count
+        frame = [[value / _SCALE for value in packed[player * count:(player + 1) * count]]
+                 for player in range(self.player_count)]
+        return delta_time, frame
+
+    def is_finished(self) -> bool:
+        """Check whether every frame has been read.
+
+        Returns:
+            True at the end of the log.
+        """
+        return self.frame_index >= self.frames
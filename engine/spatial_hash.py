@@ -0,0 +1,204 @@
+from __future__ import annotations
+
+from typing import Tuple
+
+import numpy as np
+
+# Cell coordinates are offset and packed into one int64 key per point.
+_CELL_OFFSET = 1 << 30
+_CELL_STRIDE = 1 << 31
+_NEIGHBOR_OFFSETS = [(dx, dy) for dx in (-1, 0, 1) for dy in (-1, 0, 1)]
+
+
+class SpatialHash:
+    """Uniform grid over a set of points, rebuilt from NumPy arrays.
+
+    The grid is stored as the point indices sorted by cell key, so building is
+    a single argsort and lookups are binary searches into the sorted keys.
+
+    Attributes:
+        cell_size: Width and height of a cell in world units.
+        positions: (N, 2) positions the hash was last built from.
+        order: Point indices sorted by cell key.
+        sorted_keys: Cell keys in the same order as order.
+    """
+    def __init__(self, cell_size: float) -> None:
+        """Create an empty hash.
+
+        Args:
+            cell_size: Width and height of a cell in world units.
+
+        Returns:
+            None
+        """
+        self.cell_size = float(cell_size)
+        self.positions = np.zeros((0, 2), dtype=np.float64)
+        self.cells = np.zeros((0, 2), dtype=np.int64)
+        self.order = np.zeros(0, dtype=np.int64)
+        self.sorted_keys = np.zeros(0, dtype=np.int64)
+
+    @staticmethod
+    def _keys(cells: np.ndarray) -> np.ndarray:
+        """Pack (N, 2) integer cell coordinates into int64 keys.
+
+        Args:
+            cells: Cell coordinates.
+
+        Returns:
+            Array of N keys.
+        """
+        return (cells[:, 0] + _CELL_OFFSET) * _CELL_STRIDE + (cells[:, 1] + _CELL_OFFSET)
+
+    def build(self, positions: np.ndarray) -> None:
+        """Rebuild the hash for a new set of points.
+
+        Args:
+            positions: (N, 2) array of positions.
+
+        Returns:
+            None
+        """
+        self.positions = positions
+        self.cells = np.floor(positions / self.cell_size).astype(np.int64)
+        keys = self._keys(self.cells)
+        self.order = np.argsort(keys, kind="stable")
+        self.sorted_keys = keys[self.order]
+
+    def _gather(self, query_cells: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """Find the points stored in each query cell.
+
+        Args:
+            query_cells: (M, 2) cell coordinates to look up.
+
+        Returns:
+            (query, point) index arrays, one entry per point found in a query cell.
+        """
+        keys = self._keys(query_cells)
+        lo = np.searchsorted(self.sorted_keys, keys, side="left")
+        hi = np.searchsorted(self.sorted_keys, keys, side="right")
+        counts = hi - lo
+        total = int(counts.sum())
+        if total == 0:
+            empty = np.zeros(0, dtype=np.int64)
+            return empty, empty
+        query = np.repeat(np.arange(len(query_cells)), counts)
+        # Position of each result inside its run, added to the start of that run.
+        run_starts = np.cumsum(counts) - counts
+        slots = np.arange(total) - np.repeat(run_starts, counts) + np.repeat(lo, counts)
+        return query, self.order[slots]
+
+    def query_pairs(self, radius: float) -> Tuple[np.ndarray, np.ndarray]:
+        """Find every ordered pair of distinct points closer than radius.
+
+        Radius must not exceed cell_size, since only adjacent cells are searched.
+
+        Args:
+            radius: Maximum distance between paired points.
+
+        Returns:
+            (i, j) index arrays. Each close pair appears as (i, j) and (j, i).
+        """
+        if len(self.positions) < 2:
+            empty = np.zeros(0, dtype=np.int64)
+            return empty, empty
+        firsts = []
+        seconds = []
+        for dx, dy in _NEIGHBOR_OFFSETS:
+            i, j = self._gather(self.cells + np.array((dx, dy), dtype=np.int64))
+            firsts.append(i)
+            seconds.append(j)
+        i = np.concatenate(firsts)
+        j = np.concatenate(seconds)
+        delta = self.positions[i] - self.positions[j]
+        dist_sq = np.einsum("ij,ij->i", delta, delta)
+        keep = (i != j) & (dist_sq < radius * radius)
+        return i[keep], j[keep]
+
+    def _cells_in_range(self, min_x: float, min_y: float, max_x: float, max_y: float) -> np.ndarray:
+        """List the cells overlapping an axis-aligned box.
+
+        Args:
+            min_x: Left edge.
+            min_y: Top edge.
+            max_x: Right edge.
+            max_y: Bottom edge.
+
+        Returns:
+            (M, 2) array of cell coordinates.
+        """
+        x0, y0 = int(np.floor(min_x / self.cell_size)), int(np.floor(min_y / self.cell_size))
+        x1, y1 = int(np.floor(max_x / self.cell_size)), int(np.floor(max_y / self.cell_size))
+        xs, ys = np.meshgrid(np.arange(x0, x1 + 1, dtype=np.int64), np.arange(y0, y1 + 1, dtype=np.int64))
+        return np.stack((xs.ravel(), ys.ravel()), axis=1)
+
+    def query_radius(self, x: float, y: float, radius: float) -> np.ndarray:
+        """Find the points within radius of a center.
+
+        Args:
+            x: Center x.
+            y: Center y.
+            radius: Search radius.
+
+        Returns:
+            Indices of the points found, in no particular order.
+        """
+        if len(self.positions) == 0:
+            return np.zeros(0, dtype=np.int64)
+        _, found = self._gather(self._cells_in_range(x - radius, y - radius, x + radius, y + radius))
+        delta = self.positions[found] - np.array((x, y))
+        return found[np.einsum("ij,ij->i", delta, delta) <= radius * radius]
+
+    def query_rect(self, x: float, y: float, width: float, height: float) -> np.ndarray:
+        """Find the points inside a rectangle.
+
+        Args:
+            x: Left edge.
+            y: Top edge.
+            width: Rectangle width.
+            height: Rectangle height.
+
+        Returns:
+            Indices of the points found, in no particular order.
+        """
+        if len(self.positions) == 0:
+            return np.zeros(0, dtype=np.int64)
+        _, found = self._gather(self._cells_in_range(x, y, x + width, y + height))
+        points = self.positions[found]
+        inside = ((points[:, 0] >= x) & (points[:, 0] <= x + width) &
+                  (points[:, 1] >= y) & (points[:, 1] <= y + height))
+        return found[inside]
+
+    def query_nearest(self, x: float, y: float, k: int) -> np.ndarray:
+        """Find the k points closest to a position.
+
+        The search radius starts at one cell and doubles until k points are
+        inside it, so only nearby cells are visited when points are dense.
+
+        Args:
+            x: Query x.
+            y: Query y.
+            k: Number of points to return.
+
+        Returns:
+            Indices of up to k points, closest first.
+        """
+        count = len(self.positions)
+        if count == 0 or k <= 0:
+            return np.zeros(0, dtype=np.int64)
+        center = np.array((x, y))
+        extent = np.abs(self.positions - center).max()
+        radius = self.cell_size
+        while True:
+            if radius >= extent * 1.5:
+                found = np.arange(count)
+            else:
+                found = self.query_radius(x, y, radius)
+            if len(found) >= min(k, count):
+                break
+            radius *= 2.0
+        delta = self.positions[found] - center
+        dist_sq = np.einsum("ij,ij->i", delta, delta)
+        if len(found) > k:
+            nearest = np.argpartition(dist_sq, k - 1)[:k]
+            found, dist_sq = found[nearest], dist_sq[nearest]
+        return found[np.argsort(dist_sq, kind="stable")]
@@ -0,0 +1,152 @@
+from __future__ import annotations
+
+import json
+import os
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Tuple
+
+Rect = Tuple[float, float, float, float]
+
+
+@dataclass
+class SheetFrame:
+    """A single frame in a spritesheet.
+
+    Attributes:
+        rect: Source rectangle (x, y, width, height) in pixels.
+        duration: Seconds the frame is shown.
+    """
+    rect: Rect
+    duration: float
+
+
+@dataclass
+class SheetTag:
+    """A named run of frames in a spritesheet.
+
+    Attributes:
+        name: Tag name.
+        frames: Frame indices in playback order.
+    """
+    name: str
+    frames: List[int] = field(default_factory=list)
+
+
+@dataclass
+class AsepriteSheet:
+    """Parsed Aseprite JSON export.
+
+    Attributes:
+        image: Path to the sheet image, resolved relative to the JSON file.
+        frames: Frames in export order.
+        tags: Frame tags in export order.
+    """
+    image: str
+    frames: List[SheetFrame] = field(default_factory=list)
+    tags: List[SheetTag] = field(default_factory=list)
+
+
+def grid_rects(texture_width: int, texture_height: int, frame_width: int, frame_height: int,
+               start: int = 0, count: Optional[int] = None, margin: int = 0, spacing: int = 0) -> List[Rect]:
+    """Slice a grid (or single-row strip) spritesheet into source rectangles.
+
+    Cells are numbered left to right, top to bottom.
+
+    Args:
+        texture_width: Sheet width in pixels.
+        texture_height: Sheet height in pixels.
+        frame_width: Cell width in pixels.
+        frame_height: Cell height in pixels.
+        start: Index of the first cell to take.
+        count: Number of cells to take, or None for the rest of the sheet.
+        margin: Pixels around the outside of the grid.
+        spacing: Pixels between cells.
+
+    Returns:
+        List of (x, y, width, height) rectangles.
+    """
+    columns = (texture_width - 2 * margin + spacing) // (frame_width + spacing)
+    rows = (texture_height - 2 * margin + spacing) // (frame_height + spacing)
+    total = columns * rows
+    if count is None:
+        count = total - start
+    if columns <= 0 or start < 0 or start + count > total:
+        raise ValueError(f"Frames {start}..{start + count - 1} are outside the {columns}x{rows} sheet")
+    rects: List[Rect] = []
+    for index in range(start, start + count):
+        column = index % columns
+        row = index // columns
+        rects.append((float(margin + column * (frame_width + spacing)),
+                      float(margin + row * (frame_height + spacing)),
+                      float(frame_width),
+                      float(frame_height)))
+    return rects
+
+
+def _tag_frames(start: int, end: int, direction: str) -> List[int]:
+    """Expand an Aseprite tag range into playback order.
+
+    Args:
+        start: First frame index (inclusive).
+        end: Last frame index (inclusive).
+        direction: "forward", "reverse", "pingpong", or "pingpong_reverse".
+
+    Returns:
+        Frame indices in playback order.
+    """
+    forward = list(range(start, end + 1))
+    if direction == "reverse":
+        return forward[::-1]
+    if direction == "pingpong":
+        return forward + forward[-2:0:-1]
+    if direction == "pingpong_reverse":
+        backward = forward[::-1]
+        return backward + backward[-2:0:-1]
+    return forward
+
+
+def parse_aseprite(data: Dict[str, Any], base_dir: str = "") -> AsepriteSheet:
+    """Parse an Aseprite JSON export (hash or array frame layout).
+
+    Trimmed frames are not offset back into their source size, so export with
+    trimming disabled.
+
+    Args:
+        data: Decoded JSON document.
+        base_dir: Directory the image path is relative to.
+
+    Returns:
+        The parsed sheet.
+    """
+    raw_frames = data.get("frames", [])
+    if isinstance(raw_frames, dict):
+        raw_frames = list(raw_frames.values())
+
+    meta = data.get("meta", {})
+    image = meta.get("image", "")
+    sheet = AsepriteSheet(image=os.path.join(base_dir, image).replace("\\", "/") if image else "")
+    for raw in raw_frames:
+        rect = raw["frame"]
+        if raw.get("trimmed"):
+            print(f"Trimmed Aseprite frame will be drawn without its offset: {raw.get('filename', '')}")
+        sheet.frames.append(SheetFrame(rect=(float(rect["x"]), float(rect["y"]), float(rect["w"]), float(rect["h"])),
+                                       duration=float(raw.get("duration", 100)) / 1000.0))
+
+    for raw_tag in meta.get("frameTags", []):
+        frames = _tag_frames(int(raw_tag["from"]), int(raw_tag["to"]), raw_tag.get("direction", "forward"))
+        sheet.tags.append(SheetTag(name=raw_tag["name"], frames=frames))
+    return sheet
+
+
+def load_aseprite(filename: str) -> AsepriteSheet:
+    """Load and parse an Aseprite JSON export from disk.
+
+    Args:
+        filename: Path to the JSON file.
+
+    Returns:
+        The parsed sheet.
+    """
+    with open(filename, "r", encoding="utf-8") as handle:
+        data = json.load(handle)
+    return parse_aseprite(data, os.path.dirname(filename))
@@ -1,37 +1,113 @@
+import argparse
+import time
+
 import pyray as rl
 
 from engine.framework import Game
-from engine.prefabs.managers import FontManager, WindowManager
+from engine.netcode import LossyTransport, RollbackSession, UdpTransport
+from engine.prefabs.managers import (FontManager, GcManager, InputManager, JobManager, ProfilerManager,
+                                     WindowManager, WorkerManager)
 from samples.collecting_game import CollectingScene
 from samples.fighting_game import FightingScene
 from samples.zombie_game import ZombieScene
 from samples.title_screen import TitleScreen
 
+# Fixed step used in deterministic mode (recording, replaying, --deterministic).
+FIXED_DELTA_TIME = 1.0 / 60.0
 
 game = Game()
 
 
-def update() -> None:
-    delta_time = rl.get_frame_time()
-    game.update(delta_time)
+def update(input_manager: InputManager) -> None:
+    delta_time = game.fixed_delta_time if game.fixed_delta_time > 0.0 else rl.get_frame_time()
+    game.update(input_manager.next_delta_time(delta_time))
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Game Jam Kit samples.")
+    parser.add_argument("--record", metavar="LOG", help="Record input to a log file.")
+    parser.add_argument("--replay", metavar="LOG", help="Replay input from a log file.")
+    parser.add_argument("--fast", action="store_true", help="Replay as fast as possible instead of in real time.")
+    parser.add_argument("--no-render", action="store_true", help="Skip drawing while replaying.")
+    parser.add_argument("--seed", type=int, help="Random seed (recorded in the log).")
+    parser.add_argument("--deterministic", action="store_true",
+                        help="Simulate with a fixed step and seeded random numbers (implied by --record/--replay).")
+    parser.add_argument("--netplay", type=int, choices=(0, 1), metavar="PLAYER",
+                        help="Play the fighting scene online as player 0 or 1.")
+    parser.add_argument("--port", type=int, default=7000, help="Local UDP port for netplay.")
+    parser.add_argument("--peer", default="127.0.0.1:7001", help="Peer address for netplay (host:port).")
+    parser.add_argument("--input-delay", type=int, default=2, help="Netplay input delay in frames.")
+    parser.add_argument("--net-latency", type=float, default=0.0, help="Simulated one-way latency in ms.")
+    parser.add_argument("--net-jitter", type=float, default=0.0, help="Simulated extra random latency in ms.")
+    parser.add_argument("--net-loss", type=float, default=0.0, help="Simulated packet loss (0..1).")
+    return parser.parse_args()
+
+
+def create_session(args: argparse.Namespace, input_manager: InputManager) -> RollbackSession:
+    host, port = args.peer.rsplit(":", 1)
+    transport = UdpTransport(args.port, host, int(port))
+    if args.net_latency > 0.0 or args.net_jitter > 0.0 or args.net_loss > 0.0:
+        transport = LossyTransport(transport, args.net_latency, args.net_jitter, args.net_loss, seed=args.port)
+    return RollbackSession(transport, args.netplay, 2, len(input_manager.action_names), input_delay=args.input_delay)
 
 
 def main() -> int:
+    args = parse_args()
     game.add_manager(WindowManager, 1280, 720, "Game Jam Kit")
     font_manager = game.add_manager(FontManager)
+    input_manager = game.add_manager(InputManager)
+    game.add_manager(GcManager)
+    game.add_manager(ProfilerManager)
+    game.add_manager(JobManager)
+    game.add_manager(WorkerManager)
     game.init()
 
     font_manager.load_font("Roboto", "assets/fonts/Roboto.ttf", 64)
     font_manager.load_font("Tiny5", "assets/fonts/Tiny5.ttf", 64)
     font_manager.set_texture_filter("Roboto", 4)
 
+    session = create_session(args, input_manager) if args.netplay is not None else None
+
     game.add_scene("title", TitleScreen)
-    game.add_scene("fighting", FightingScene)
+    game.add_scene("fighting", FightingScene, session)
     game.add_scene("collecting", CollectingScene)
     game.add_scene("zombie", ZombieScene)
 
+    seed = args.seed if args.seed is not None else int(time.time())
+    if args.replay:
+        seed = input_manager.start_replay(args.replay)
+        if args.fast:
+            rl.set_target_fps(0)
+        game.draw_enabled = not args.no_render
+    elif args.record:
+        input_manager.start_recording(args.record, seed)
+    game.seed = seed
+    rl.set_random_seed(seed)
+    if args.deterministic or args.record or args.replay:
+        game.fixed_delta_time = FIXED_DELTA_TIME
+    if session:
+        game.go_to_scene("fighting")
+
+    frames = 0
+    start = time.perf_counter()
+    desync_reported = False
     while not rl.window_should_close():
-        update()
+        if input_manager.is_replay_finished():
+            break
+        update(input_manager)
+        frames += 1
+        if session and session.desync_frame is not None and not desync_reported:
+            print(f"Netplay desync: state differs from the peer's at frame {session.desync_frame}")
+            desync_reported = True
+
+    if args.replay:
+        elapsed = time.perf_counter() - start
+        print(f"Replayed {frames} frames in {elapsed:.3f} s ({frames / max(elapsed, 1e-9):.1f} FPS)")
+    if session:
+        print(session.get_summary())
+        session.close()
+    input_manager.stop()
+    game.shutdown()
     return 0
 
 
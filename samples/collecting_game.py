@@ -1,4 +1,4 @@
-"""Demonstration of split screen cameras and sensor-based item collection."""
+"""Demonstration of split screen cameras and item collection."""
 
 from __future__ import annotations
 
@@ -8,14 +8,17 @@ from typing import List
 from Box2D import b2CircleShape, b2PolygonShape
 import pyray as rl
 
+from engine import render
 from engine.framework import GameObject, Scene
 from engine.math_extensions import vec_div, vec_mul, vec_normalize, vec_sub, v2
 from engine.prefabs.components import (AnimationController, BodyComponent, MultiComponent,
                                        PlatformerMovementComponent, PlatformerMovementParams,
                                        SoundComponent)
 from engine.prefabs.game_objects import CharacterParams, SplitCamera
-from engine.prefabs.managers import FontManager, WindowManager
-from engine.prefabs.services import LevelService, PhysicsService, SoundService, TextureService
+from engine.prefabs.managers import FontManager, InputManager, PlayerInput, WindowManager
+from engine.prefabs.services import (AnimationSystem, LevelService, ParticleEmitter, ParticleService, PhysicsService,
+                                     SoundService, SpatialHashService, TextureService, TickLodService,
+                                     TimerService)
 
 
 class CollectingCharacter(GameObject):
@@ -37,10 +40,13 @@ component, and drive animations/sounds from gameplay events."""
         self.p = params
         self.player_number = player_number
         self.gamepad = player_number - 1
+        self.input: PlayerInput = None  # type: ignore[assignment]
         self.width = params.width
         self.height = params.height
         self.physics: PhysicsService = None  # type: ignore[assignment]
         self.level: LevelService = None  # type: ignore[assignment]
+        self.pickups: SpatialHashService = None  # type: ignore[assignment]
+        self.pickup_radius = 16.0
         self.body: BodyComponent = None  # type: ignore[assignment]
         self.movement: PlatformerMovementComponent = None  # type: ignore[assignment]
         self.animation: AnimationController = None  # type: ignore[assignment]
@@ -59,6 +65,7 @@ component, and drive animations/sounds from gameplay events."""
             None
         """
         self.physics = self.scene.get_service(PhysicsService)
+        self.input = self.scene.game.get_manager(InputManager).get_player(self.gamepad)
 
         def build_body(component: BodyComponent):
             """Build body.
@@ -89,35 +96,19 @@ component, and drive animations/sounds from gameplay events."""
         self.movement = self.add_component(PlatformerMovementComponent(movement_params))
 
         self.level = self.scene.get_service(LevelService)
+        self.pickups = self.scene.get_service(SpatialHashService)
 
         self.sounds = self.add_component(MultiComponent())
         self.jump_sound = self.sounds.add_component("jump", SoundComponent, "assets/sounds/jump.wav")
         self.die_sound = self.sounds.add_component("die", SoundComponent, "assets/sounds/die.wav")
 
+        # Each player's two run frames sit side by side in the first row of the character sheet.
         self.animation = self.add_component(AnimationController(self.body))
-        if self.player_number == 1:
-            self.animation.add_animation_from_files("run",
-                                                   ["assets/pixel_platformer/characters/green_1.png",
-                                                    "assets/pixel_platformer/characters/green_2.png"],
-                                                   10.0)
-        elif self.player_number == 2:
-            self.animation.add_animation_from_files("run",
-                                                   ["assets/pixel_platformer/characters/blue_1.png",
-                                                    "assets/pixel_platformer/characters/blue_2.png"],
-                                                   10.0)
-        elif self.player_number == 3:
-            self.animation.add_animation_from_files("run",
-                                                   ["assets/pixel_platformer/characters/pink_1.png",
-                                                    "assets/pixel_platformer/characters/pink_2.png"],
-                                                   10.0)
-        elif self.player_number == 4:
-            self.animation.add_animation_from_files("run",
-                                                   ["assets/pixel_platformer/characters/yellow_1.png",
-                                                    "assets/pixel_platformer/characters/yellow_2.png"],
-                                                   10.0)
+        self.animation.add_animation_from_sheet("run", "assets/pixel_platformer/characters.png", 24, 24,
+                                                start=(self.player_number - 1) * 2, count=2, fps=10.0)
 
     def update(self, delta_time: float) -> None:
-        """Handle input and drive movement/animation.
+        """Handle input, drive movement/animation, and pick up nearby coins.
 
         Args:
             delta_time: Seconds since last frame.
@@ -125,17 +116,9 @@ component, and drive animations/sounds from gameplay events."""
         Returns:
             None
         """
-        deadzone = 0.1
-        jump_pressed = rl.is_key_pressed(rl.KEY_W) or rl.is_gamepad_button_pressed(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-        jump_held = rl.is_key_down(rl.KEY_W) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-
-        move_x = rl.get_gamepad_axis_movement(self.gamepad, rl.GAMEPAD_AXIS_LEFT_X)
-        if abs(move_x) < deadzone:
-            move_x = 0.0
-        if rl.is_key_down(rl.KEY_D) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_RIGHT):
-            move_x = 1.0
-        elif rl.is_key_down(rl.KEY_A) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_LEFT):
-            move_x = -1.0
+        jump_pressed = self.input.pressed[InputManager.JUMP]
+        jump_held = self.input.down[InputManager.JUMP]
+        move_x = self.input.values[InputManager.MOVE_X]
 
         self.movement.set_input(move_x, jump_pressed, jump_held)
         if self.movement.grounded and jump_pressed:
@@ -147,12 +130,16 @@ component, and drive animations/sounds from gameplay events."""
         else:
             self.animation.pause()
 
+        for coin in self.pickups.query_radius("coin", self.body.get_position_pixels(), self.pickup_radius):
+            coin.collect(self)
+
     def die(self) -> None:
         """Respawn the character at the start position.
 
         Returns:
             None
         """
+        self.scene.particles.emit(self.scene.burst, self.body.get_position_pixels(), 60)
         self.body.set_position(self.p.position)
         self.body.set_velocity(v2(0.0, 0.0))
         self.die_sound.play()
@@ -165,7 +152,10 @@ class EnemyType:
 
 
 class Enemy(GameObject):
-    """Enemy that patrols between two points using a kinematic body."""
+    """Enemy that patrols between two points using a kinematic body.
+
+    Patrol checks run every other frame, and less often away from the cameras.
+    """
     def __init__(self, enemy_type: int, start: rl.Vector2, end: rl.Vector2) -> None:
         """Configure the patrol endpoints and enemy type.
 
@@ -231,6 +221,8 @@ class Enemy(GameObject):
                                                     "assets/pixel_platformer/enemies/block_head_2.png"],
                                                    5.0)
         self.animation.play("move")
+        self.set_tick_interval(2)
+        self.scene.get_service(TickLodService).add(self, self.body)
 
         super().init_object()
 
@@ -264,7 +256,7 @@ class Enemy(GameObject):
 
 
 class Coin(GameObject):
-    """Collectible coin using a sensor body."""
+    """Collectible coin, found by characters through SpatialHashService."""
     def __init__(self, position: rl.Vector2) -> None:
         """Store the coin spawn position.
 
@@ -314,24 +306,25 @@ class Coin(GameObject):
                                                5.0)
         self.animation.play("spin")
         self.collect_sound = self.add_component(SoundComponent("assets/sounds/coin.wav"))
+        self.scene.get_service(SpatialHashService).add("coin", self.body)
 
-    def update(self, delta_time: float) -> None:
-        """Check sensor overlaps and award score on pickup.
+    def collect(self, character: CollectingCharacter) -> None:
+        """Award the coin to a character and remove it.
 
         Args:
-            delta_time: Seconds since last frame.
+            character: Character that touched the coin.
 
         Returns:
             None
         """
-        for contact_body in self.body.get_sensor_overlaps():
-            user_data = contact_body.userData
-            if user_data and user_data.has_tag("character"):
-                self.collect_sound.play()
-                self.is_active = False
-                self.body.disable()
-                user_data.score += 1
-                break
+        # Two characters can reach the same coin in one frame; the first one gets it.
+        if not self.is_active:
+            return
+        self.collect_sound.play()
+        self.scene.particles.emit(self.scene.sparkle, self.body.get_position_pixels(), 16)
+        self.is_active = False
+        self.body.disable()
+        character.score += 1
 
 
 class CollectingScene(Scene):
@@ -351,6 +344,29 @@ class CollectingScene(Scene):
         self.cameras: List[SplitCamera] = []
         self.screen_size = v2(0.0, 0.0)
         self.scale = 2.5
+        self.particles: ParticleService = None  # type: ignore[assignment]
+        self.sparkle = ParticleEmitter()
+        self.sparkle.direction = -90.0
+        self.sparkle.spread = 120.0
+        self.sparkle.speed_min = 30.0
+        self.sparkle.speed_max = 90.0
+        self.sparkle.life_min = 0.3
+        self.sparkle.life_max = 0.6
+        self.sparkle.size = 2.0
+        self.sparkle.gravity = v2(0.0, 200.0)
+        self.sparkle.color = rl.Color(255, 230, 90, 255)
+        self.sparkle.color_end = rl.Color(255, 255, 255, 0)
+        self.burst = ParticleEmitter()
+        self.burst.speed_min = 60.0
+        self.burst.speed_max = 200.0
+        self.burst.life_min = 0.5
+        self.burst.life_max = 1.0
+        self.burst.size = 3.0
+        self.burst.size_end = 1.0
+        self.burst.gravity = v2(0.0, 400.0)
+        self.burst.bounce = 0.4
+        self.burst.color = rl.Color(230, 41, 55, 255)
+        self.burst.color_end = rl.Color(120, 20, 30, 0)
 
     def init_services(self) -> None:
         """Register services required by the scene.
@@ -360,9 +376,16 @@ class CollectingScene(Scene):
         """
         self.add_service(TextureService)
         self.add_service(SoundService)
+        # Coins, enemies, and characters are advanced together instead of per object.
+        self.add_service(AnimationSystem)
+        self.add_service(TimerService)
         self.physics = self.add_service(PhysicsService)
+        # Characters look up nearby coins here instead of every coin polling its sensor each frame.
+        self.add_service(SpatialHashService, 32.0)
+        self.add_service(TickLodService, [(400.0, 1), (800.0, 2)])
         collision_names = ["walls", "clouds", "trees"]
         self.level = self.add_service(LevelService, "assets/levels/collecting.ldtk", "Level", collision_names)
+        self.particles = self.add_service(ParticleService, 20000, collide_with_level=True)
 
     def init(self) -> None:
         """Create characters, enemies, coins, and cameras.
@@ -414,6 +437,7 @@ class CollectingScene(Scene):
         for _ in self.characters:
             cam = self.add_game_object(SplitCamera(vec_div(self.screen_size, self.scale), self.level.get_size()))
             self.cameras.append(cam)
+            self.get_service(TickLodService).add_viewer(lambda cam=cam: cam.target)
 
     def update(self, delta_time: float) -> None:
         """Update camera targets and handle window resizing.
@@ -428,7 +452,7 @@ class CollectingScene(Scene):
             camera.target = self.characters[idx].body.get_position_pixels()
 
         new_screen_size = v2(float(rl.get_screen_width()), float(rl.get_screen_height()))
-        if new_screen_size.x != self.screen_size.x or new_screen_size.y != self.screen_size.y:
+        if not self.game.headless and (new_screen_size.x != self.screen_size.x or new_screen_size.y != self.screen_size.y):
             self.screen_size = new_screen_size
             screen_scale = self.window_manager.get_width() / self.screen_size.x
             for camera in self.cameras:
@@ -439,7 +463,7 @@ class CollectingScene(Scene):
                 camera.renderer = rl.load_render_texture(int(camera.size.x), int(camera.size.y))
 
         # Trigger scene change on Enter key or gamepad start button.
-        if rl.is_key_pressed(rl.KEY_ENTER) or rl.is_gamepad_button_pressed(0, rl.GAMEPAD_BUTTON_MIDDLE_RIGHT):
+        if self.game.get_manager(InputManager).players[0].pressed[InputManager.START]:
             self.game.go_to_scene_next()
 
     def draw_scene(self) -> None:
@@ -457,39 +481,39 @@ class CollectingScene(Scene):
         for i, camera in enumerate(self.cameras):
             if i == 0:
                 camera.draw_texture_pro(0, 0, self.screen_size.x / 2.0, self.screen_size.y / 2.0)
-                rl.draw_text_ex(self.font_manager.get_font("Tiny5"),
-                           f"Score: {self.characters[0].score}",
-                           v2(20.0, 20.0),
-                           40.0,
-                           2.0,
-                           rl.BLACK)
+                render.draw_text_ex(self.font_manager.get_font("Tiny5"),
+                                    f"Score: {self.characters[0].score}",
+                                    v2(20.0, 20.0),
+                                    40.0,
+                                    2.0,
+                                    rl.BLACK)
             elif i == 1:
                 camera.draw_texture_pro(self.screen_size.x / 2.0, 0, self.screen_size.x / 2.0, self.screen_size.y / 2.0)
-                rl.draw_text_ex(self.font_manager.get_font("Tiny5"),
-                           f"Score: {self.characters[1].score}",
-                           v2(self.screen_size.x / 2.0 + 20.0, 20.0),
-                           40.0,
-                           2.0,
-                           rl.BLACK)
+                render.draw_text_ex(self.font_manager.get_font("Tiny5"),
+                                    f"Score: {self.characters[1].score}",
+                                    v2(self.screen_size.x / 2.0 + 20.0, 20.0),
+                                    40.0,
+                                    2.0,
+                                    rl.BLACK)
             elif i == 2:
                 camera.draw_texture_pro(0, self.screen_size.y / 2.0, self.screen_size.x / 2.0, self.screen_size.y / 2.0)
-                rl.draw_text_ex(self.font_manager.get_font("Tiny5"),
-                           f"Score: {self.characters[2].score}",
-                           v2(20.0, self.screen_size.y / 2.0 + 20.0),
-                           40.0,
-                           2.0,
-                           rl.BLACK)
+                render.draw_text_ex(self.font_manager.get_font("Tiny5"),
+                                    f"Score: {self.characters[2].score}",
+                                    v2(20.0, self.screen_size.y / 2.0 + 20.0),
+                                    40.0,
+                                    2.0,
+                                    rl.BLACK)
             elif i == 3:
                 camera.draw_texture_pro(self.screen_size.x / 2.0,
                                         self.screen_size.y / 2.0,
                                         self.screen_size.x / 2.0,
                                         self.screen_size.y / 2.0)
-                rl.draw_text_ex(self.font_manager.get_font("Tiny5"),
-                           f"Score: {self.characters[3].score}",
-                           v2(self.screen_size.x / 2.0 + 20.0, self.screen_size.y / 2.0 + 20.0),
-                           40.0,
-                           2.0,
-                           rl.BLACK)
-
-        rl.draw_line_ex(v2(self.screen_size.x / 2.0, 0), v2(self.screen_size.x / 2.0, self.screen_size.y), 4.0, rl.Color(130, 130, 130, 255))
-        rl.draw_line_ex(v2(0, self.screen_size.y / 2.0), v2(self.screen_size.x, self.screen_size.y / 2.0), 4.0, rl.Color(130, 130, 130, 255))
+                render.draw_text_ex(self.font_manager.get_font("Tiny5"),
+                                    f"Score: {self.characters[3].score}",
+                                    v2(self.screen_size.x / 2.0 + 20.0, self.screen_size.y / 2.0 + 20.0),
+                                    40.0,
+                                    2.0,
+                                    rl.BLACK)
+
+        render.draw_line_ex(v2(self.screen_size.x / 2.0, 0), v2(self.screen_size.x / 2.0, self.screen_size.y), 4.0, rl.Color(130, 130, 130, 255))
+        render.draw_line_ex(v2(0, self.screen_size.y / 2.0), v2(self.screen_size.x, self.screen_size.y / 2.0), 4.0, rl.Color(130, 130, 130, 255))
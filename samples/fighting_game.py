@@ -5,18 +5,22 @@ Shows LDtk level setup, one-way platforms, and simple combat interactions."""
 from __future__ import annotations
 
 import math
-from typing import List
+from typing import Any, List, Optional
 
 from Box2D import b2ContactListener, b2PolygonShape, b2Vec2
 import pyray as rl
 
+from engine import render
 from engine.framework import GameObject, Scene
 from engine.math_extensions import vec_add, vec_div, vec_mul, vec_sub, v2
-from engine.prefabs.components import (AnimationController, BodyComponent, MultiComponent,
-                                       PlatformerMovementComponent, PlatformerMovementParams,
-                                       SoundComponent)
+from engine.netcode import RollbackSession
+from engine.prefabs.components import (AnimationController, AnimationStateMachine, BodyComponent,
+                                       MultiComponent, PlatformerMovementComponent,
+                                       PlatformerMovementParams, SoundComponent, TransformComponent)
 from engine.prefabs.game_objects import CameraObject, CharacterParams, StaticBox
-from engine.prefabs.services import LevelService, PhysicsService, SoundService, TextureService
+from engine.prefabs.managers import InputManager, PlayerInput
+from engine.prefabs.services import (LevelService, PhysicsService, SnapshotService, SoundService, TextureService,
+                                     TimerService, TransformService)
 
 
 class FightingCharacter(GameObject):
@@ -35,23 +39,38 @@ class FightingCharacter(GameObject):
         self.p = params
         self.player_number = player_number
         self.gamepad = player_number - 1
+        self.input: PlayerInput = None  # type: ignore[assignment]
         self.width = params.width
         self.height = params.height
         self.physics: PhysicsService = None  # type: ignore[assignment]
+        self.timers: TimerService = None  # type: ignore[assignment]
         self.level: LevelService = None  # type: ignore[assignment]
         self.body: BodyComponent = None  # type: ignore[assignment]
+        self.attack_point: TransformComponent = None  # type: ignore[assignment]
         self.movement: PlatformerMovementComponent = None  # type: ignore[assignment]
         self.animation: AnimationController = None  # type: ignore[assignment]
+        self.animation_states: AnimationStateMachine = None  # type: ignore[assignment]
+        self.speed_param = 0
+        self.grounded_param = 0
+        self.vertical_speed_param = 0
         self.sounds: MultiComponent = None  # type: ignore[assignment]
         self.jump_sound: SoundComponent = None  # type: ignore[assignment]
         self.hit_sound: SoundComponent = None  # type: ignore[assignment]
         self.die_sound: SoundComponent = None  # type: ignore[assignment]
-        self.fall_through = False
-        self.fall_through_timer = 0.0
+        self.fall_through_until = 0.0
         self.fall_through_duration = 0.2
-        self.attack_display_timer = 0.0
+        self.attack_until = 0.0
         self.attack_display_duration = 0.1
-        self.attack = False
+
+    @property
+    def fall_through(self) -> bool:
+        """True while one-way platforms let this character drop through."""
+        return self.timers.time < self.fall_through_until
+
+    @property
+    def attack(self) -> bool:
+        """True while the attack indicator is shown."""
+        return self.timers.time < self.attack_until
 
     def init(self) -> None:
         """Initialize body, movement, sounds, and animations.
@@ -60,6 +79,8 @@ class FightingCharacter(GameObject):
             None
         """
         self.physics = self.scene.get_service(PhysicsService)
+        self.timers = self.scene.get_service(TimerService)
+        self.input = self.scene.game.get_manager(InputManager).get_player(self.gamepad)
 
         def build_body(component: BodyComponent):
             """Build body.
@@ -82,6 +103,8 @@ class FightingCharacter(GameObject):
             component.body = body
 
         self.body = self.add_component(BodyComponent(build=build_body))
+        # Center of the attack hitbox, on the side the character faces.
+        self.attack_point = self.add_component(TransformComponent(self.body, v2(self.width / 2.0 + 8.0, 0.0)))
 
         movement_params = PlatformerMovementParams()
         movement_params.width = self.p.width
@@ -179,6 +202,21 @@ class FightingCharacter(GameObject):
             self.animation.add_animation_from_files("fall", ["assets/sunnyland/imp/jump-4.png"], 0.0)
             self.animation.origin.y += 10
 
+        # The squirrel has no separate fall animation, so it keeps playing its jump.
+        self.animation_states = self.add_component(AnimationStateMachine(self.animation))
+        self.speed_param = self.animation_states.add_parameter("speed", 0.0)
+        self.grounded_param = self.animation_states.add_parameter("grounded", True)
+        self.vertical_speed_param = self.animation_states.add_parameter("vertical_speed", 0.0)
+        self.animation_states.add_state("idle")
+        self.animation_states.add_state("run")
+        self.animation_states.add_state("jump")
+        self.animation_states.add_state("fall", "jump" if self.player_number == 3 else "fall")
+        self.animation_states.add_transition("*", "jump", [("grounded", "==", False), ("vertical_speed", "<", 0.0)])
+        self.animation_states.add_transition("*", "fall", [("grounded", "==", False), ("vertical_speed", ">=", 0.0)])
+        self.animation_states.add_transition("*", "run", [("grounded", "==", True), ("speed", ">", 0.1)])
+        self.animation_states.add_transition("*", "idle", [("grounded", "==", True), ("speed", "<=", 0.1)])
+        self.animation_states.set_initial_state("idle")
+
     def update(self, delta_time: float) -> None:
         """Handle input, jumping, attacks, and respawn logic.
 
@@ -188,70 +226,54 @@ class FightingCharacter(GameObject):
         Returns:
             None
         """
-        deadzone = 0.1
-        jump_pressed = rl.is_key_pressed(rl.KEY_W) or rl.is_gamepad_button_pressed(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-        jump_held = rl.is_key_down(rl.KEY_W) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_DOWN)
-
-        move_x = rl.get_gamepad_axis_movement(self.gamepad, rl.GAMEPAD_AXIS_LEFT_X)
-        if abs(move_x) < deadzone:
-            move_x = 0.0
-        if rl.is_key_down(rl.KEY_D) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_RIGHT):
-            move_x = 1.0
-        elif rl.is_key_down(rl.KEY_A) or rl.is_gamepad_button_down(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_LEFT):
-            move_x = -1.0
+        jump_pressed = self.input.pressed[InputManager.JUMP]
+        jump_held = self.input.down[InputManager.JUMP]
+        move_x = self.input.values[InputManager.MOVE_X]
 
         self.movement.set_input(move_x, jump_pressed, jump_held)
 
         if self.movement.grounded and jump_pressed:
-            self.jump_sound.play()
+            self.play_sound(self.jump_sound)
 
         if abs(self.movement.move_x) > 0.1:
-            self.animation.play("run")
             self.animation.flip_x = self.movement.move_x < 0.0
-        else:
-            self.animation.play("idle")
-
-        if not self.movement.grounded:
-            if self.player_number != 3:
-                if self.body.get_velocity_meters().y < 0.0:
-                    self.animation.play("jump")
-                else:
-                    self.animation.play("fall")
-            else:
-                self.animation.play("jump")
-
-        move_y = rl.get_gamepad_axis_movement(self.gamepad, rl.GAMEPAD_AXIS_LEFT_Y)
-        if rl.is_key_pressed(rl.KEY_S) or rl.is_gamepad_button_pressed(self.gamepad, rl.GAMEPAD_BUTTON_LEFT_FACE_DOWN) or move_y > 0.5:
-            self.fall_through = True
-            self.fall_through_timer = self.fall_through_duration
-
-        if self.fall_through_timer > 0.0:
-            self.fall_through_timer = max(0.0, self.fall_through_timer - delta_time)
-            if self.fall_through_timer == 0.0:
-                self.fall_through = False
-
-        if rl.is_key_pressed(rl.KEY_SPACE) or rl.is_gamepad_button_pressed(self.gamepad, rl.GAMEPAD_BUTTON_RIGHT_FACE_RIGHT):
-            self.attack = True
-            self.attack_display_timer = self.attack_display_duration
-            position = self.body.get_position_pixels()
-            position.x += (self.width / 2.0 + 8.0) * (-1.0 if self.animation.flip_x else 1.0)
-            bodies = self.physics.circle_overlap(position, 8.0, self.body.body)
+        # Derived from flip_x every frame so a rollback that restores flip_x also moves the hitbox.
+        reach = self.width / 2.0 + 8.0
+        self.attack_point.set_local_position(v2(-reach if self.animation.flip_x else reach, 0.0))
+        self.animation_states.set_parameter(self.speed_param, abs(self.movement.move_x))
+        self.animation_states.set_parameter(self.grounded_param, self.movement.grounded)
+        self.animation_states.set_parameter(self.vertical_speed_param, self.body.get_velocity_meters().y)
+
+        # A key or d-pad press drops through once; a stick held down keeps dropping.
+        if self.input.pressed[InputManager.DOWN] or self.input.values[InputManager.STICK_Y] > 0.5:
+            self.fall_through_until = self.timers.deadline(self.fall_through_duration)
+
+        if self.input.pressed[InputManager.ATTACK]:
+            self.attack_until = self.timers.deadline(self.attack_display_duration)
+            bodies = self.physics.circle_overlap(self.attack_point.get_world_position(), 8.0, self.body.body)
             for other_body in bodies:
                 if other_body == self.body.body:
                     continue
                 impulse = b2Vec2(-10.0 if self.animation.flip_x else 10.0, -10.0)
                 other_body.ApplyLinearImpulse(impulse=impulse, point=other_body.worldCenter, wake=True)
-                self.hit_sound.play()
-
-        if self.attack_display_timer > 0.0:
-            self.attack_display_timer = max(0.0, self.attack_display_timer - delta_time)
-            if self.attack_display_timer == 0.0:
-                self.attack = False
+                self.play_sound(self.hit_sound)
 
         if self.body.get_position_pixels().y > self.level.get_size().y + 200.0:
             self.body.set_position(self.p.position)
             self.body.set_velocity(v2(0.0, 0.0))
-            self.die_sound.play()
+            self.play_sound(self.die_sound)
+
+    def play_sound(self, sound: SoundComponent) -> None:
+        """Play a sound, unless the frame is being resimulated after a rollback.
+
+        Args:
+            sound: Sound to play.
+
+        Returns:
+            None
+        """
+        if not self.scene.is_resimulating():
+            sound.play()
 
     def draw(self) -> None:
         """Draw attack indicator (animations are drawn by controller).
@@ -260,9 +282,7 @@ class FightingCharacter(GameObject):
             None
         """
         if self.attack:
-            position = self.body.get_position_pixels()
-            position.x += (self.width / 2.0 + 8.0) * (-1.0 if self.animation.flip_x else 1.0)
-            rl.draw_circle_v(position, 8.0, rl.Color(230, 41, 55, 128))
+            render.draw_circle_v(self.attack_point.get_world_position(), 8.0, rl.Color(230, 41, 55, 128))
 
     def pre_solve(self, body_a, body_b, contact, platforms: List[StaticBox]) -> bool:
         """Custom pre-solve for one-way platforms.
@@ -328,18 +348,30 @@ class FightingContactListener(b2ContactListener):
 
 
 class FightingScene(Scene):
-    """Scene demonstrating shared camera and arena combat."""
-    def __init__(self) -> None:
+    """Scene demonstrating shared camera and arena combat.
+
+    With a RollbackSession the scene runs online: only the session's players
+    are spawned, and every frame is simulated through the session, which
+    predicts remote input and rolls back via SnapshotService when it was wrong.
+    """
+    def __init__(self, session: Optional[RollbackSession] = None) -> None:
         """Initialize scene storage for platforms, fighters, and services.
 
+        Args:
+            session: Rollback session for online play, or None for local play.
+
         Returns:
             None
         """
         super().__init__()
+        self.session = session
+        self.snapshots: SnapshotService = None  # type: ignore[assignment]
+        self.snapshot_buffers: List[Any] = []
         self.platforms: List[StaticBox] = []
         self.characters: List[FightingCharacter] = []
         self.level: LevelService = None  # type: ignore[assignment]
         self.physics: PhysicsService = None  # type: ignore[assignment]
+        self.timers: TimerService = None  # type: ignore[assignment]
         self.camera: CameraObject = None  # type: ignore[assignment]
         self.renderer = None
         self.render_rect = None
@@ -352,9 +384,13 @@ class FightingScene(Scene):
         """
         self.add_service(TextureService)
         self.add_service(SoundService)
+        self.timers = self.add_service(TimerService)
         self.physics = self.add_service(PhysicsService)
+        self.add_service(TransformService)
         collision_names = ["walls"]
         self.level = self.add_service(LevelService, "assets/levels/fighting.ldtk", "Stage", collision_names)
+        if self.session:
+            self.snapshots = self.add_service(SnapshotService)
 
     def init(self) -> None:
         """Create platforms, players, camera, and render target.
@@ -375,7 +411,8 @@ class FightingScene(Scene):
             self.physics.world.contactListener = FightingContactListener(self)
 
         player_entities = self.level.get_entities_by_name("Start")
-        for i, player_entity in enumerate(player_entities[:4]):
+        player_count = self.session.player_count if self.session else 4
+        for i, player_entity in enumerate(player_entities[:player_count]):
             params = CharacterParams()
             params.position = self.level.convert_to_pixels(player_entity.getPosition())
             params.width = 16
@@ -388,7 +425,112 @@ class FightingScene(Scene):
         self.camera.target = vec_div(self.level.get_size(), 2.0)
 
         self.level.set_layer_visibility("Background", False)
-        self.renderer = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
+        if not self.game.headless:
+            self.renderer = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
+
+        if self.session:
+            # Everything a frame reads that is not derived from the bodies.
+            self.snapshots.register_field(self.timers, "time")
+            for character in self.characters:
+                self.snapshots.register_fields(character, ["fall_through_until", "attack_until"])
+                self.snapshots.register_fields(character.movement, ["grounded", "coyote_until",
+                                                                    "jump_buffer_until"])
+                self.snapshots.register_field(character.animation, "flip_x")
+            self.session.attach(self.save_state, self.load_state, self.simulate, self.checksum)
+            # Player state changes only in simulate, starting from neutral input.
+            input_manager = self.game.get_manager(InputManager)
+            input_manager.apply_polled = False
+            input_manager.apply(self.session.get_inputs(-1))
+
+    def unload(self) -> None:
+        """Unload the render target.
+
+        Returns:
+            None
+        """
+        if self.renderer:
+            rl.unload_render_texture(self.renderer)
+            self.renderer = None
+
+    def is_resimulating(self) -> bool:
+        """Check whether the current frame is a rollback resimulation (skip sounds and effects).
+
+        Returns:
+            True while the session resimulates.
+        """
+        return bool(self.session and self.session.is_resimulating)
+
+    def save_state(self, frame: int) -> None:
+        """Capture the state before a frame into the snapshot ring.
+
+        Args:
+            frame: Frame about to be simulated.
+
+        Returns:
+            None
+        """
+        if not self.snapshot_buffers:
+            self.snapshot_buffers = [self.snapshots.allocate() for _ in range(self.session.snapshot_count())]
+        self.snapshots.capture(self.snapshot_buffers[frame % len(self.snapshot_buffers)])
+
+    def load_state(self, frame: int) -> None:
+        """Restore the state captured before a frame.
+
+        Args:
+            frame: Frame to simulate next.
+
+        Returns:
+            None
+        """
+        self.snapshots.restore(self.snapshot_buffers[frame % len(self.snapshot_buffers)])
+        self.game.get_manager(InputManager).apply(self.session.get_inputs(frame - 1))
+
+    def checksum(self, frame: int) -> int:
+        """Checksum the state captured before a frame, to compare with the peer.
+
+        Args:
+            frame: Frame whose snapshot to checksum; still in the snapshot ring.
+
+        Returns:
+            CRC32 of the snapshot.
+        """
+        return self.snapshots.checksum(self.snapshot_buffers[frame % len(self.snapshot_buffers)])
+
+    def simulate(self, inputs: List[List[float]]) -> None:
+        """Advance one fixed step with the session's inputs.
+
+        Args:
+            inputs: Action values per player.
+
+        Returns:
+            None
+        """
+        self.game.get_manager(InputManager).apply(inputs)
+        super().update_scene(self.physics.time_step)
+
+    def update_scene(self, delta_time: float) -> None:
+        """Update locally, or hand the frame to the rollback session.
+
+        Args:
+            delta_time: Seconds since last frame.
+
+        Returns:
+            None
+        """
+        if not self.session:
+            super().update_scene(delta_time)
+            return
+        # begin_frame polled the devices without applying them; player 0's values are this machine's input.
+        self.session.advance(self.game.get_manager(InputManager).polled[0])
+
+    def on_exit(self) -> None:
+        """Give player state back to the input devices.
+
+        Returns:
+            None
+        """
+        if self.session:
+            self.game.get_manager(InputManager).apply_polled = True
 
     def update(self, delta_time: float) -> None:
         """Update camera framing and compute render placement.
@@ -426,8 +568,8 @@ class FightingScene(Scene):
         pos = vec_div(vec_sub(v2(float(rl.get_screen_width()), float(rl.get_screen_height())), render_size), 2.0)
         self.render_rect = rl.Rectangle(pos.x, pos.y, render_size.x, render_size.y)
 
-        # Trigger scene change on Enter key or gamepad start button.
-        if rl.is_key_pressed(rl.KEY_ENTER) or rl.is_gamepad_button_pressed(0, rl.GAMEPAD_BUTTON_MIDDLE_RIGHT):
+        # Trigger scene change on Enter key or gamepad start button (local play only).
+        if not self.session and self.game.get_manager(InputManager).players[0].pressed[InputManager.START]:
             self.game.go_to_scene_next()
 
     def draw_scene(self) -> None:
@@ -436,17 +578,17 @@ class FightingScene(Scene):
         Returns:
             None
         """
-        rl.begin_texture_mode(self.renderer)
+        render.begin_texture_mode(self.renderer)
         rl.clear_background(rl.MAGENTA)
         self.level.draw_layer("Background")
         self.camera.draw_begin()
         super().draw_scene()
         self.camera.draw_end()
-        rl.end_texture_mode()
-
-        rl.draw_texture_pro(self.renderer.texture,
-                       rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
-                       self.render_rect,
-                       v2(0.0, 0.0),
-                       0.0,
-                       rl.Color(255, 255, 255, 255))
+        render.end_texture_mode()
+
+        render.draw_texture_pro(self.renderer.texture,
+                                rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
+                                self.render_rect,
+                                v2(0.0, 0.0),
+                                0.0,
+                                rl.Color(255, 255, 255, 255))
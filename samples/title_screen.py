@@ -1,8 +1,9 @@
 import pyray as rl
 
+from engine import render
 from engine.math_extensions import v2
 from engine.framework import Scene
-from engine.prefabs.includes import FontManager
+from engine.prefabs.includes import FontManager, InputManager
 
 
 class TitleScreen(Scene):
@@ -17,7 +18,7 @@ class TitleScreen(Scene):
 
     def update(self, delta_time):
         # Trigger scene change on Enter key or gamepad start button.
-        if rl.is_key_pressed(rl.KEY_ENTER) or rl.is_gamepad_button_pressed(0, rl.GAMEPAD_BUTTON_MIDDLE_RIGHT):
+        if self.game.get_manager(InputManager).players[0].pressed[InputManager.START]:
             self.game.go_to_scene_next()
 
     def draw(self):
@@ -29,7 +30,7 @@ class TitleScreen(Scene):
         subtitle_text_size = rl.measure_text_ex(self.font, subtitle, 32, 0)
 
         rl.clear_background(rl.SKYBLUE)
-        rl.draw_text_ex(
+        render.draw_text_ex(
             self.font,
             self.title,
             v2((width - title_text_size.x) / 2, (height - title_text_size.y - 100) / 2),
@@ -37,7 +38,7 @@ class TitleScreen(Scene):
             1,
             rl.WHITE,
         )
-        rl.draw_text_ex(
+        render.draw_text_ex(
             self.font,
             subtitle,
             v2((width - subtitle_text_size.x) / 2, (height - subtitle_text_size.y + 100) / 2),
@@ -3,18 +3,22 @@
 from __future__ import annotations
 
 import math
-from typing import List
+from typing import Generator, List, Optional
 
 from Box2D import b2CircleShape, b2Vec2
+import numpy as np
 import pyray as rl
 
+from engine import render
 from engine.framework import GameObject, Scene
 from engine.math_extensions import vec_add, vec_mul, vec_sub, v2
-from engine.prefabs.components import (BodyComponent, MultiComponent, SoundComponent,
+from engine.prefabs.components import (BodyComponent, CrowdAgentComponent, MultiComponent, SoundComponent,
                                        SpriteComponent, TopDownMovementComponent,
-                                       TopDownMovementParams)
-from engine.prefabs.managers import FontManager
-from engine.prefabs.services import LevelService, PhysicsService, SoundService, TextureService
+                                       TopDownMovementParams, TransformComponent)
+from engine.prefabs.managers import FontManager, InputManager, PlayerInput
+from engine.prefabs.services import (CrowdService, LevelService, ParticleEmitter, ParticleService, PhysicsService,
+                                     RandomService, SoundService, TextureService, Timer, TimerService,
+                                     TransformService)
 
 RLGL_SRC_ALPHA = 0x0302
 RLGL_MIN = 0x8007
@@ -74,14 +78,21 @@ class Bullet(GameObject):
         Returns:
             None
         """
-        for contact_body in self.body.get_contacts():
-            self.is_active = False
-            self.body.set_position(v2(-1000.0, -1000.0))
-            self.body.set_velocity(v2(0.0, 0.0))
+        contacts = self.body.get_contacts()
+        if not contacts:
+            return
+        # One hit per bullet: sparks where it stopped, then kill the first zombie it touches.
+        self.scene.particles.emit(self.scene.sparks, self.body.get_position_pixels(), 12)
+        self.is_active = False
+        self.body.set_position(v2(-1000.0, -1000.0))
+        self.body.set_velocity(v2(0.0, 0.0))
+        for contact_body in contacts:
             other = contact_body.userData
             if other and other.has_tag("zombie"):
                 self.hit_sound.play()
+                self.scene.particles.emit(self.scene.blood, other.body.get_position_pixels(), 40)
                 other.is_active = False
+                self.scene.zombies_killed += 1
                 zombie_body = other.get_component(BodyComponent)
                 if zombie_body:
                     zombie_body.set_position(v2(-1000.0, -1000.0))
@@ -110,10 +121,18 @@ class TopDownCharacter(GameObject):
         self.position = position
         self.bullets = bullets
         self.player_num = player_num
+        self.input: PlayerInput = None  # type: ignore[assignment]
         self.health = 10
-        self.contact_timer = 1.0
+        # The first hit needs a second of contact; later ones come every contact_cooldown seconds.
+        self.contact_delay = 1.0
         self.contact_cooldown = 0.3
+        self.contact_timer: Optional[Timer] = None
+        self.is_touching_zombie = False
+        self.timers: TimerService = None  # type: ignore[assignment]
         self.body: BodyComponent = None  # type: ignore[assignment]
+        self.transforms: MultiComponent = None  # type: ignore[assignment]
+        self.aim: TransformComponent = None  # type: ignore[assignment]
+        self.muzzle: TransformComponent = None  # type: ignore[assignment]
         self.physics: PhysicsService = None  # type: ignore[assignment]
         self.sprite: SpriteComponent = None  # type: ignore[assignment]
         self.movement: TopDownMovementComponent = None  # type: ignore[assignment]
@@ -127,6 +146,8 @@ class TopDownCharacter(GameObject):
             None
         """
         self.physics = self.scene.get_service(PhysicsService)
+        self.timers = self.scene.get_service(TimerService)
+        self.input = self.scene.game.get_manager(InputManager).get_player(self.player_num)
 
         def build_body(component: BodyComponent):
             """Build body.
@@ -147,6 +168,10 @@ class TopDownCharacter(GameObject):
             component.body = body
 
         self.body = self.add_component(BodyComponent(build=build_body))
+        # The aim turns with the facing direction; bullets leave from the muzzle in front of it.
+        self.transforms = self.add_component(MultiComponent())
+        self.aim = self.transforms.add_component("aim", TransformComponent, self.body)
+        self.muzzle = self.transforms.add_component("muzzle", TransformComponent, self.aim, v2(48.0, 0.0))
 
         params = TopDownMovementParams()
         params.accel = 5000.0
@@ -157,7 +182,10 @@ class TopDownCharacter(GameObject):
         self.sounds = self.add_component(MultiComponent())
         self.shoot_sound = self.sounds.add_component("shoot", SoundComponent, "assets/sounds/shoot.wav")
 
-        self.sprite = self.add_component(SpriteComponent(f"assets/zombie_shooter/player_{self.player_num + 1}.png"))
+        self.sprite = self.add_component(SpriteComponent(f"assets/zombie_shooter/player_{self.player_num + 1}.png",
+                                                         self.body, follow_rotation=False))
+
+        self.scene.get_service(CrowdService).add_target(self.body)
 
     def update(self, delta_time: float) -> None:
         """Handle movement, shooting, and damage over time.
@@ -168,68 +196,75 @@ class TopDownCharacter(GameObject):
         Returns:
             None
         """
-        move = v2(0.0, 0.0)
-        move = v2(rl.get_gamepad_axis_movement(self.player_num, rl.GAMEPAD_AXIS_LEFT_X),
-                  rl.get_gamepad_axis_movement(self.player_num, rl.GAMEPAD_AXIS_LEFT_Y))
-
-        if rl.is_key_down(rl.KEY_W) or rl.is_gamepad_button_down(self.player_num, rl.GAMEPAD_BUTTON_LEFT_FACE_UP):
-            move.y -= 1.0
-        if rl.is_key_down(rl.KEY_S) or rl.is_gamepad_button_down(self.player_num, rl.GAMEPAD_BUTTON_LEFT_FACE_DOWN):
-            move.y += 1.0
-        if rl.is_key_down(rl.KEY_A) or rl.is_gamepad_button_down(self.player_num, rl.GAMEPAD_BUTTON_LEFT_FACE_LEFT):
-            move.x -= 1.0
-        if rl.is_key_down(rl.KEY_D) or rl.is_gamepad_button_down(self.player_num, rl.GAMEPAD_BUTTON_LEFT_FACE_RIGHT):
-            move.x += 1.0
-
-        self.movement.set_input(move.x, move.y)
-        self.sprite.set_position(self.body.get_position_pixels())
+        self.movement.set_input(self.input.values[InputManager.MOVE_X], self.input.values[InputManager.MOVE_Y])
         self.sprite.set_rotation(self.movement.facing_dir)
+        self.aim.set_local_rotation(self.movement.facing_dir)
 
-        if rl.is_key_pressed(rl.KEY_SPACE) or rl.is_gamepad_button_pressed(self.player_num, rl.GAMEPAD_BUTTON_RIGHT_FACE_RIGHT):
+        if self.input.pressed[InputManager.ATTACK]:
             for bullet in self.bullets:
                 if not bullet.is_active:
                     self.shoot_sound.play()
-                    char_pos = self.body.get_position_pixels()
                     shoot_dir = v2(math.cos(math.radians(self.movement.facing_dir)),
                                    math.sin(math.radians(self.movement.facing_dir)))
-                    bullet_start = v2(char_pos.x + shoot_dir.x * 48.0, char_pos.y + shoot_dir.y * 48.0)
-                    bullet.body.set_position(bullet_start)
-                    bullet.body.set_rotation(self.movement.facing_dir + 90.0)
+                    bullet.body.set_position(self.muzzle.get_world_position())
+                    bullet.body.set_rotation(self.muzzle.get_world_rotation() + 90.0)
                     bullet.body.set_velocity(v2(shoot_dir.x * bullet.speed, shoot_dir.y * bullet.speed))
                     bullet.is_active = True
                     break
 
+        self.is_touching_zombie = False
         for contact_body in self.body.get_contacts():
             other = contact_body.userData
             if other and other.has_tag("zombie"):
-                if self.contact_timer > 0.0:
-                    self.contact_timer -= delta_time
-                if self.contact_timer <= 0.0:
-                    self.health -= 1
-                    self.contact_timer = self.contact_cooldown
-                    if self.health <= 0:
-                        self.is_active = False
-                        self.body.set_position(v2(-1000.0, -1000.0))
-                        self.body.set_velocity(v2(0.0, 0.0))
+                self.is_touching_zombie = True
+                break
+        if self.is_touching_zombie and (self.contact_timer is None or self.contact_timer.is_done):
+            self.contact_timer = self.timers.after(self.contact_delay, self.take_contact_damage)
+
+    def take_contact_damage(self) -> None:
+        """Lose health if a zombie is still touching when the contact timer fires.
+
+        Returns:
+            None
+        """
+        if not self.is_active or not self.is_touching_zombie:
+            return
+        self.health -= 1
+        self.contact_delay = self.contact_cooldown
+        self.timers.start(self.flash())
+        if self.health <= 0:
+            self.is_active = False
+            self.body.set_position(v2(-1000.0, -1000.0))
+            self.body.set_velocity(v2(0.0, 0.0))
+
+    def flash(self) -> Generator[float, None, None]:
+        """Task that tints the sprite red for a moment after a hit.
+
+        Returns:
+            Generator run by TimerService.
+        """
+        self.sprite.tint = rl.RED
+        yield 0.1
+        self.sprite.tint = rl.WHITE
 
 
 class Zombie(GameObject):
-    """Enemy that chases the closest player."""
-    def __init__(self, players: List[TopDownCharacter]) -> None:
-        """Store the list of players to chase.
+    """Enemy that chases the closest player.
 
-        Args:
-            players: Player characters to target.
+    Steering is done by CrowdService, and ZombieScene turns every zombie's
+    sprite to its steering direction in one pass over the archetype columns.
+    """
+    def __init__(self) -> None:
+        """Prepare component references and cached services.
 
         Returns:
             None
         """
         super().__init__()
-        self.players = players
         self.body: BodyComponent = None  # type: ignore[assignment]
         self.physics: PhysicsService = None  # type: ignore[assignment]
         self.sprite: SpriteComponent = None  # type: ignore[assignment]
-        self.movement: TopDownMovementComponent = None  # type: ignore[assignment]
+        self.movement: CrowdAgentComponent = None  # type: ignore[assignment]
 
     def init(self) -> None:
         """Create body, movement, and sprite (starts inactive).
@@ -264,36 +299,10 @@ class Zombie(GameObject):
         params.accel = 5000.0
         params.friction = 5000.0
         params.max_speed = 100.0
-        self.movement = self.add_component(TopDownMovementComponent(params))
-
-        self.sprite = self.add_component(SpriteComponent("assets/zombie_shooter/zombie.png"))
+        self.movement = self.add_component(CrowdAgentComponent(params))
 
-    def update(self, delta_time: float) -> None:
-        """Move toward the closest player and update sprite.
-
-        Args:
-            delta_time: Seconds since last frame.
-
-        Returns:
-            None
-        """
-        closest_pos = v2(0.0, 0.0)
-        closest_dist_sq = float("inf")
-        for player in self.players:
-            player_pos = player.body.get_position_pixels()
-            to_player = vec_sub(player_pos, self.body.get_position_pixels())
-            dist_sq = to_player.x * to_player.x + to_player.y * to_player.y
-            if dist_sq < closest_dist_sq:
-                closest_dist_sq = dist_sq
-                closest_pos = player_pos
-        to_closest = vec_sub(closest_pos, self.body.get_position_pixels())
-        length = math.sqrt(to_closest.x * to_closest.x + to_closest.y * to_closest.y)
-        if length > 0.0:
-            to_closest.x /= length
-            to_closest.y /= length
-        self.movement.set_input(to_closest.x, to_closest.y)
-        self.sprite.set_position(self.body.get_position_pixels())
-        self.sprite.set_rotation(self.movement.facing_dir)
+        self.sprite = self.add_component(SpriteComponent("assets/zombie_shooter/zombie.png", self.body,
+                                                         follow_rotation=False))
 
 
 class Spawner(GameObject):
@@ -310,33 +319,37 @@ class Spawner(GameObject):
             None
         """
         super().__init__()
-        self.spawn_timer = 0.0
         self.spawn_interval = 1.0
         self.position = vec_sub(position, vec_mul(size, 0.5))
         self.size = size
         self.zombie_pool = zombies
+        self.random: RandomService = None  # type: ignore[assignment]
+        self.spawn_timer: Optional[Timer] = None
 
-    def update(self, delta_time: float) -> None:
-        """Spawn zombies at an interval within a rectangle.
+    def init(self) -> None:
+        """Cache the scene's random number generator and start spawning.
 
-        Args:
-            delta_time: Seconds since last frame.
+        Returns:
+            None
+        """
+        self.random = self.scene.get_service(RandomService)
+        self.spawn_timer = self.scene.get_service(TimerService).every(self.spawn_interval, self.spawn, delay=0.0)
+
+    def spawn(self) -> None:
+        """Activate a pooled zombie at a random point of the spawn area.
 
         Returns:
             None
         """
-        self.spawn_timer -= delta_time
-        if self.spawn_timer <= 0.0:
-            self.spawn_timer = self.spawn_interval
-            x = self.position.x + float(rl.get_random_value(0, int(self.size.x)))
-            y = self.position.y + float(rl.get_random_value(0, int(self.size.y)))
-            spawn_pos = v2(x, y)
-            for zombie in self.zombie_pool:
-                if not zombie.is_active:
-                    zombie.body.set_position(spawn_pos)
-                    zombie.is_active = True
-                    zombie.body.enable()
-                    return
+        x = self.position.x + float(self.random.get_value(0, int(self.size.x)))
+        y = self.position.y + float(self.random.get_value(0, int(self.size.y)))
+        spawn_pos = v2(x, y)
+        for zombie in self.zombie_pool:
+            if not zombie.is_active:
+                zombie.body.set_position(spawn_pos)
+                zombie.is_active = True
+                zombie.body.enable()
+                return
 
 
 class ZombieScene(Scene):
@@ -350,13 +363,37 @@ class ZombieScene(Scene):
         super().__init__()
         self.font_manager: FontManager = None  # type: ignore[assignment]
         self.physics: PhysicsService = None  # type: ignore[assignment]
+        self.timers: TimerService = None  # type: ignore[assignment]
+        self.crowd: CrowdService = None  # type: ignore[assignment]
         self.level: LevelService = None  # type: ignore[assignment]
+        self.particles: ParticleService = None  # type: ignore[assignment]
+        self.sparks = ParticleEmitter()
+        self.sparks.speed_min = 80.0
+        self.sparks.speed_max = 260.0
+        self.sparks.life_min = 0.15
+        self.sparks.life_max = 0.4
+        self.sparks.size = 4.0
+        self.sparks.drag = 4.0
+        self.sparks.bounce = 0.5
+        self.sparks.color = rl.Color(255, 220, 120, 255)
+        self.sparks.color_end = rl.Color(255, 80, 0, 0)
+        self.blood = ParticleEmitter()
+        self.blood.speed_min = 30.0
+        self.blood.speed_max = 180.0
+        self.blood.life_min = 0.4
+        self.blood.life_max = 0.9
+        self.blood.size = 6.0
+        self.blood.size_end = 2.0
+        self.blood.drag = 6.0
+        self.blood.color = rl.Color(120, 200, 60, 255)
+        self.blood.color_end = rl.Color(40, 90, 20, 0)
         self.renderer: rl.RenderTexture = None  # type: ignore[assignment]
         self.light_map: rl.RenderTexture = None  # type: ignore[assignment]
         self.light_texture: rl.Texture2D = None  # type: ignore[assignment]
         self.bullets: List[Bullet] = []
         self.characters: List[TopDownCharacter] = []
         self.zombies: List[Zombie] = []
+        self.zombies_killed = 0
 
     def init_services(self) -> None:
         """Register services required by the scene.
@@ -366,9 +403,18 @@ class ZombieScene(Scene):
         """
         self.add_service(TextureService)
         self.add_service(SoundService)
+        self.add_service(RandomService)
+        self.timers = self.add_service(TimerService)
         self.physics = self.add_service(PhysicsService, b2Vec2(0.0, 0.0))
+        self.add_service(TransformService)
+        # Zombie steering runs for the whole horde at once, after the physics step.
+        # Each zombie looks for the closest player every fourth frame, and zombies far
+        # from that player are steered every second or fourth frame.
+        self.crowd = self.add_service(CrowdService, separation_radius=32.0, retarget_interval=4,
+                                      lod_bands=[(400.0, 1), (900.0, 2), (1600.0, 4)])
         collision_names = ["walls", "obstacles"]
         self.level = self.add_service(LevelService, "assets/levels/top_down.ldtk", "Level", collision_names)
+        self.particles = self.add_service(ParticleService, collide_with_level=True)
         self.font_manager = self.game.get_manager(FontManager)
 
     def init(self) -> None:
@@ -390,7 +436,7 @@ class ZombieScene(Scene):
             self.characters.append(character)
 
         for _ in range(100):
-            zombie = self.add_game_object(Zombie(self.characters))
+            zombie = self.add_game_object(Zombie())
             zombie.is_active = False
             zombie.add_tag("zombie")
             self.zombies.append(zombie)
@@ -402,15 +448,46 @@ class ZombieScene(Scene):
 
         self.level.set_layer_visibility("Foreground", False)
 
-        self.renderer = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
-        self.light_map = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
+        if not self.game.headless:
+            self.renderer = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
+            self.light_map = rl.load_render_texture(int(self.level.get_size().x), int(self.level.get_size().y))
         self.light_texture = self.get_service(TextureService).get_texture("assets/zombie_shooter/light.png")
 
+    def unload(self) -> None:
+        """Unload the render targets.
+
+        Returns:
+            None
+        """
+        if self.renderer:
+            rl.unload_render_texture(self.renderer)
+            rl.unload_render_texture(self.light_map)
+            self.renderer = None
+            self.light_map = None
+
     def update(self, delta_time: float) -> None:
         # Trigger scene change on Enter key or gamepad start button.
-        if rl.is_key_pressed(rl.KEY_ENTER) or rl.is_gamepad_button_pressed(0, rl.GAMEPAD_BUTTON_MIDDLE_RIGHT):
+        if self.game.get_manager(InputManager).players[0].pressed[InputManager.START]:
             self.game.go_to_scene_next()
 
+    def update_scene(self, delta_time: float) -> None:
+        """Update the scene, then face every zombie along its new steering direction.
+
+        Args:
+            delta_time: Seconds since last frame.
+
+        Returns:
+            None
+        """
+        super().update_scene(delta_time)
+        facing = self.crowd.facing
+        for chunk in self.query(CrowdAgentComponent, SpriteComponent):
+            slots = chunk.field(CrowdAgentComponent, "slot")
+            registered = np.flatnonzero(slots >= 0)
+            sprites = chunk.column(SpriteComponent)
+            for row, rotation in zip(registered.tolist(), facing[slots[registered]].tolist()):
+                sprites[row].rotation = rotation
+
     def draw_scene(self) -> None:
         """Build light mask and render the final frame.
 
@@ -423,45 +500,45 @@ class ZombieScene(Scene):
         Returns:
             None
         """
-        rl.begin_texture_mode(self.light_map)
+        render.begin_texture_mode(self.light_map)
         rl.clear_background(rl.BLACK)
-        rl.rl_set_blend_factors(RLGL_SRC_ALPHA, RLGL_SRC_ALPHA, RLGL_MIN)
-        rl.rl_set_blend_mode(rl.BLEND_CUSTOM)
+        render.set_blend_factors(RLGL_SRC_ALPHA, RLGL_SRC_ALPHA, RLGL_MIN)
+        render.set_blend_mode(rl.BLEND_CUSTOM)
 
         for i in range(min(4, len(self.characters))):
             pos = self.characters[i].body.get_position_pixels()
-            rl.draw_texture(self.light_texture,
-                        int(pos.x - self.light_texture.width / 2),
-                        int(pos.y - self.light_texture.height / 2),
-                        rl.WHITE)
+            render.draw_texture(self.light_texture,
+                                int(pos.x - self.light_texture.width / 2),
+                                int(pos.y - self.light_texture.height / 2),
+                                rl.WHITE)
 
-        rl.rl_draw_render_batch_active()
-        rl.rl_set_blend_mode(rl.BLEND_ALPHA)
-        rl.end_texture_mode()
+        render.draw_render_batch_active()
+        render.set_blend_mode(rl.BLEND_ALPHA)
+        render.end_texture_mode()
 
-        rl.begin_texture_mode(self.renderer)
+        render.begin_texture_mode(self.renderer)
         rl.clear_background(rl.Color(255, 0, 255, 255))
         super().draw_scene()
         self.level.draw_layer("Foreground")
-        rl.draw_texture_pro(self.light_map.texture,
-                       rl.Rectangle(0.0, 0.0, float(self.light_map.texture.width), -float(self.light_map.texture.height)),
-                       rl.Rectangle(0.0, 0.0, float(self.light_map.texture.width), float(self.light_map.texture.height)),
-                       v2(0.0, 0.0),
-                       0.0,
-                       rl.color_alpha(rl.WHITE, 0.92))
-        rl.draw_rectangle(10, 10, 210, 210, rl.color_alpha(rl.WHITE, 0.3))
+        render.draw_texture_pro(self.light_map.texture,
+                                rl.Rectangle(0.0, 0.0, float(self.light_map.texture.width), -float(self.light_map.texture.height)),
+                                rl.Rectangle(0.0, 0.0, float(self.light_map.texture.width), float(self.light_map.texture.height)),
+                                v2(0.0, 0.0),
+                                0.0,
+                                rl.color_alpha(rl.WHITE, 0.92))
+        render.draw_rectangle(10, 10, 210, 210, rl.color_alpha(rl.WHITE, 0.3))
         health_lines = [f"Health: {char.health}" for char in self.characters[:4]]
-        rl.draw_text_ex(self.font_manager.get_font("Roboto"),
-                   "\n".join(health_lines),
-                   v2(20.0, 20.0),
-                   45.0,
-                   1.0,
-                   rl.Color(230, 41, 55, 255))
-        rl.end_texture_mode()
-
-        rl.draw_texture_pro(self.renderer.texture,
-                       rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
-                       rl.Rectangle(0.0, 0.0, float(rl.get_screen_width()), float(rl.get_screen_height())),
-                       v2(0.0, 0.0),
-                       0.0,
-                       rl.WHITE)
+        render.draw_text_ex(self.font_manager.get_font("Roboto"),
+                            "\n".join(health_lines),
+                            v2(20.0, 20.0),
+                            45.0,
+                            1.0,
+                            rl.Color(230, 41, 55, 255))
+        render.end_texture_mode()
+
+        render.draw_texture_pro(self.renderer.texture,
+                                rl.Rectangle(0.0, 0.0, float(self.renderer.texture.width), -float(self.renderer.texture.height)),
+                                rl.Rectangle(0.0, 0.0, float(rl.get_screen_width()), float(rl.get_screen_height())),
+                                v2(0.0, 0.0),
+                                0.0,
+                                rl.WHITE)
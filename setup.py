@@ -0,0 +1,100 @@
+"""Optional compiled build of the engine core.
+
+The modules in COMPILED_MODULES are plain, type-annotated Python. Cython can
+compile them unchanged (pure-Python mode) into extension modules that sit next
+to the sources and are imported in their place:
+
+    pip install cython
+    python setup.py build_ext --inplace
+
+Nothing else changes: without Cython or a C compiler the build is skipped with
+a warning and the interpreted sources are used. Remove the compiled modules to
+go back to the interpreted sources:
+
+    python setup.py clean_compiled
+
+Compare the two with tools/bench_scenes.py.
+"""
+
+from __future__ import annotations
+
+import glob
+import os
+import sys
+
+from setuptools import Command, setup
+from setuptools.command.build_ext import build_ext
+
+COMPILED_MODULES = [
+    "engine/ecs.py",
+    "engine/framework.py",
+    "engine/math_extensions.py",
+    "engine/raycasts.py",
+    "engine/render.py",
+    "engine/prefabs/components.py",
+]
+
+
+class clean_compiled(Command):  # noqa: N801
+    """Delete extension modules and generated C built from COMPILED_MODULES."""
+    description = "remove compiled engine modules"
+    user_options = []
+
+    def initialize_options(self) -> None:
+        pass
+
+    def finalize_options(self) -> None:
+        pass
+
+    def run(self) -> None:
+        for source in COMPILED_MODULES:
+            stem = os.path.splitext(source)[0]
+            for path in glob.glob(stem + ".c") + glob.glob(stem + ".*.so") + glob.glob(stem + ".*.pyd"):
+                print(f"removing {path}")
+                os.remove(path)
+
+
+class optional_build_ext(build_ext):  # noqa: N801
+    """build_ext that warns instead of failing, leaving the interpreted sources in use."""
+    def run(self) -> None:
+        try:
+            super().run()
+        except Exception as error:  # noqa: BLE001
+            print(f"Compiled build skipped, using interpreted sources: {error}", file=sys.stderr)
+
+    def build_extension(self, ext) -> None:
+        try:
+            super().build_extension(ext)
+        except Exception as error:  # noqa: BLE001
+            print(f"Could not compile {ext.name}, using interpreted source: {error}", file=sys.stderr)
+
+
+def compiled_extensions():
+    """Cythonize COMPILED_MODULES if Cython is available.
+
+    Annotation typing is off so annotations stay documentation: `x: float`
+    would otherwise become a C double and reject values the interpreted code
+    accepts. Classes stay regular Python classes, so game code can keep
+    subclassing Component, GameObject, and Scene.
+
+    Returns:
+        List of extensions, empty when Cython is not installed.
+    """
+    try:
+        from Cython.Build import cythonize
+    except ImportError:
+        print("Cython not installed, using interpreted sources.", file=sys.stderr)
+        return []
+    return cythonize(COMPILED_MODULES,
+                     compiler_directives={"language_level": 3,
+                                          "annotation_typing": False,
+                                          "binding": True,
+                                          "embedsignature": True})
+
+
+setup(
+    name="game_jam_kit",
+    packages=["engine", "engine.prefabs"],
+    ext_modules=compiled_extensions() if "clean_compiled" not in sys.argv else [],
+    cmdclass={"build_ext": optional_build_ext, "clean_compiled": clean_compiled},
+)
@@ -0,0 +1,274 @@
+"""Run many headless simulations of a sample scene in parallel.
+
+Each instance builds the scene in a headless game (no window, textures, or
+audio), overrides the players' movement parameters, drives every player with
+a seeded random bot, and steps M frames as fast as possible. Instances are
+spread across worker processes, which write their metrics into one shared
+memory array. Every instance gets a fresh game, shut down once its metrics are
+written, so no scene resources or manager state carry over to the next one:
+
+    python -m tools.batch_runner zombie --param max_speed=250,350,450 --repeats 4 --frames 1800
+
+Every combination of --param values is run --repeats times with different
+seeds. Parameters are attributes of the scene's movement params
+(TopDownMovementParams or PlatformerMovementParams).
+"""
+
+from __future__ import annotations
+
+import argparse
+import itertools
+import json
+import multiprocessing
+import random
+import statistics
+import time
+from multiprocessing import shared_memory
+from typing import Any, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from engine.framework import Game, Manager, Scene
+from engine.prefabs.managers import FontManager, InputManager, WindowManager
+from samples.collecting_game import CollectingScene
+from samples.fighting_game import FightingScene
+from samples.zombie_game import ZombieScene
+
+SCENES = {
+    "fighting": FightingScene,
+    "collecting": CollectingScene,
+    "zombie": ZombieScene,
+}
+METRICS = ("distance", "zombies_killed", "mean_frame_ms", "max_frame_ms")
+FIXED_DELTA_TIME = 1.0 / 60.0
+
+# Per-process state, set up by init_worker.
+_results: Optional[np.ndarray] = None
+_memory: Optional[shared_memory.SharedMemory] = None
+_scene_name = ""
+_frames = 0
+
+
+class RandomBot:
+    """Scripted input: every player wanders, jumps, and attacks at random."""
+    def __init__(self, input_manager: InputManager, seed: int) -> None:
+        """Create the bot.
+
+        Args:
+            input_manager: Manager whose action layout the bot fills.
+            seed: Seed for the bot's choices.
+
+        Returns:
+            None
+        """
+        self.random = random.Random(seed)
+        self.action_count = len(input_manager.action_names)
+        self.frames = [[0.0] * self.action_count for _ in range(input_manager.player_count)]
+        self.hold = [0] * input_manager.player_count
+
+    def __call__(self) -> List[List[float]]:
+        """Produce the next frame of input.
+
+        Returns:
+            Action values per player.
+        """
+        for player, values in enumerate(self.frames):
+            if self.hold[player] <= 0:
+                self.hold[player] = self.random.randint(15, 60)
+                values[InputManager.MOVE_X] = float(self.random.choice((-1, 0, 1)))
+                values[InputManager.MOVE_Y] = float(self.random.choice((-1, 0, 1)))
+            self.hold[player] -= 1
+            values[InputManager.JUMP] = 1.0 if self.random.random() < 0.05 else 0.0
+            # Release between shots so every attack is a new press.
+            attack = values[InputManager.ATTACK] == 0.0 and self.random.random() < 0.2
+            values[InputManager.ATTACK] = 1.0 if attack else 0.0
+        return self.frames
+
+
+class ParamOverrideManager(Manager):
+    """Apply movement parameter overrides to the players as each scene is initialized.
+
+    Runs from Game.update's on_scene_init, so overrides are in place before the
+    scene's first update, exactly like the scene would start in a real run.
+
+    Attributes:
+        params: Movement parameter name -> value for the next scene.
+        start_positions: Player positions right after the last scene was initialized.
+    """
+    def __init__(self) -> None:
+        """Create the manager with no overrides.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.params: Dict[str, float] = {}
+        self.start_positions: List[Any] = []
+
+    def on_scene_init(self, scene: Scene) -> None:
+        """Override the players' movement parameters.
+
+        Args:
+            scene: The scene that was initialized.
+
+        Returns:
+            None
+
+        Raises:
+            ValueError: If a parameter does not exist.
+        """
+        characters = scene.characters
+        for character in characters:
+            for name, value in self.params.items():
+                if not hasattr(character.movement.p, name):
+                    raise ValueError(f"{type(character.movement.p).__name__} has no parameter '{name}'")
+                setattr(character.movement.p, name, type(getattr(character.movement.p, name))(value))
+        self.start_positions = [character.body.get_position_pixels() for character in characters]
+
+
+def init_worker(memory_name: str, shape: Tuple[int, int], scene_name: str, frames: int) -> None:
+    """Attach to the result array and remember what every instance simulates.
+
+    Args:
+        memory_name: Name of the shared memory block holding results.
+        shape: (instances, metrics) shape of the result array.
+        scene_name: Scene to simulate.
+        frames: Frames per instance.
+
+    Returns:
+        None
+    """
+    global _results, _memory, _scene_name, _frames
+    _memory = shared_memory.SharedMemory(name=memory_name)
+    _results = np.ndarray(shape, dtype=np.float64, buffer=_memory.buf)
+    _scene_name = scene_name
+    _frames = frames
+
+
+def create_game(seed: int) -> Game:
+    """Create a headless game for one instance.
+
+    Args:
+        seed: Seed for the scene's random number generators.
+
+    Returns:
+        Initialized game with no scene.
+    """
+    game = Game()
+    game.headless = True
+    game.fixed_delta_time = FIXED_DELTA_TIME
+    game.seed = seed
+    game.add_manager(WindowManager, 1280, 720, "Batch runner")
+    game.add_manager(FontManager)
+    game.add_manager(InputManager)
+    game.add_manager(ParamOverrideManager)
+    game.init()
+    return game
+
+
+def run_instance(task: Tuple[int, Dict[str, float], int]) -> int:
+    """Simulate one instance and write its metrics row.
+
+    Args:
+        task: (row index, movement parameter overrides, seed).
+
+    Returns:
+        The row index.
+    """
+    index, params, seed = task
+    game = create_game(seed)
+    scene = game.add_scene(_scene_name, SCENES[_scene_name])
+    input_manager = game.get_manager(InputManager)
+    input_manager.source = RandomBot(input_manager, seed)
+    overrides = game.get_manager(ParamOverrideManager)
+    overrides.params = params
+
+    distance = 0.0
+    last: List[Any] = []
+    frame_ms: List[float] = []
+    for _ in range(_frames):
+        start = time.perf_counter()
+        # The first update initializes the scene and applies the overrides.
+        game.update(FIXED_DELTA_TIME)
+        frame_ms.append((time.perf_counter() - start) * 1000.0)
+        if not last:
+            last = list(overrides.start_positions)
+        for i, character in enumerate(scene.characters):
+            position = character.body.get_position_pixels()
+            distance += ((position.x - last[i].x) ** 2 + (position.y - last[i].y) ** 2) ** 0.5
+            last[i] = position
+
+    _results[index] = (distance, getattr(scene, "zombies_killed", 0), statistics.fmean(frame_ms), max(frame_ms))
+    game.shutdown()
+    return index
+
+
+def parse_params(specs: List[str]) -> List[Dict[str, float]]:
+    """Expand --param NAME=V1,V2 options into every combination.
+
+    Args:
+        specs: Option values.
+
+    Returns:
+        One override dict per combination.
+    """
+    names = []
+    values = []
+    for spec in specs:
+        name, _, raw = spec.partition("=")
+        names.append(name)
+        values.append([float(value) for value in raw.split(",")])
+    return [dict(zip(names, combination)) for combination in itertools.product(*values)]
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Run headless simulations of a sample scene in parallel.")
+    parser.add_argument("scene", choices=list(SCENES))
+    parser.add_argument("--param", action="append", default=[], metavar="NAME=V1,V2",
+                        help="Movement parameter values to sweep (repeatable).")
+    parser.add_argument("--repeats", type=int, default=4, help="Seeds per parameter combination.")
+    parser.add_argument("--frames", type=int, default=1800, help="Frames per instance.")
+    parser.add_argument("--processes", type=int, default=multiprocessing.cpu_count())
+    parser.add_argument("--seed", type=int, default=1, help="Seed of the first instance.")
+    parser.add_argument("--json", help="Write per-instance results to this file.")
+    args = parser.parse_args()
+
+    combinations = parse_params(args.param)
+    tasks = [(index, params, args.seed + index)
+             for index, params in enumerate(p for p in combinations for _ in range(args.repeats))]
+    shape = (len(tasks), len(METRICS))
+    memory = shared_memory.SharedMemory(create=True, size=max(1, int(np.prod(shape)) * 8))
+    try:
+        results = np.ndarray(shape, dtype=np.float64, buffer=memory.buf)
+        results.fill(np.nan)
+        start = time.perf_counter()
+        context = multiprocessing.get_context("spawn")
+        with context.Pool(args.processes, init_worker, (memory.name, shape, args.scene, args.frames)) as pool:
+            for _ in pool.imap_unordered(run_instance, tasks):
+                pass
+        elapsed = time.perf_counter() - start
+        results = results.copy()
+    finally:
+        memory.close()
+        memory.unlink()
+
+    total_frames = len(tasks) * args.frames
+    print(f"{len(tasks)} instances x {args.frames} frames in {elapsed:.2f} s "
+          f"({total_frames / max(elapsed, 1e-9):.0f} frames/s across {args.processes} processes)")
+    header = "  ".join(f"{metric:>14}" for metric in METRICS)
+    print(f"{'params':<40}{header}")
+    for i, params in enumerate(combinations):
+        rows = results[i * args.repeats:(i + 1) * args.repeats]
+        label = ", ".join(f"{name}={value:g}" for name, value in params.items()) or "(defaults)"
+        print(f"{label:<40}" + "  ".join(f"{value:>14.3f}" for value in rows.mean(axis=0)))
+
+    if args.json:
+        output: List[Dict[str, Any]] = []
+        for (index, params, seed), row in zip(tasks, results):
+            output.append({"params": params, "seed": seed, **dict(zip(METRICS, row.tolist()))})
+        with open(args.json, "w", encoding="utf-8") as handle:
+            json.dump(output, handle, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,268 @@
+"""Headless frame-time benchmark of the sample scenes.
+
+Opens a hidden window, runs every sample scene for a fixed number of frames at
+a fixed time step with the frame limiter off, and reports update+draw time per
+frame, plus the average render counts from engine.render (draw calls, batch
+flushes, texture/render target/blend switches) in total, per camera, and per
+owner type. It also times SnapshotService capture and restore on a scene of
+dynamic bodies with a few registered fields each (the rollback budget is
+under 1 ms for 500 bodies). Run it once with the interpreted sources and once after
+`python setup.py build_ext --inplace` to compare:
+
+    python -m tools.bench_scenes [--frames N] [--warmup N] [--json out.json] [--no-render-stats]
+                                 [--snapshot-bodies N]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import statistics
+import time
+from typing import Any, Dict, List
+
+from Box2D import b2CircleShape
+import pyray as rl
+
+import engine.framework
+from engine import render
+from engine.framework import Game, GameObject, Scene
+from engine.prefabs.components import BodyComponent
+from engine.prefabs.managers import FontManager, GcManager, InputManager, WindowManager
+from engine.prefabs.services import PhysicsService, SnapshotService
+from samples.collecting_game import CollectingScene
+from samples.fighting_game import FightingScene
+from samples.zombie_game import ZombieScene
+
+SCENES = {
+    "fighting": FightingScene,
+    "collecting": CollectingScene,
+    "zombie": ZombieScene,
+}
+
+
+class SnapshotBody(GameObject):
+    """Dynamic circle with the kind of gameplay fields a rollback snapshot registers."""
+    def __init__(self, x: float, y: float) -> None:
+        """Create the object.
+
+        Args:
+            x: Horizontal position in pixels.
+            y: Vertical position in pixels.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.x = x
+        self.y = y
+        self.health = 100
+        self.cooldown = 0.0
+        self.body: BodyComponent = None  # type: ignore[assignment]
+
+    def init(self) -> None:
+        """Build the body and register the fields.
+
+        Returns:
+            None
+        """
+        def build_body(component: BodyComponent) -> None:
+            """Create a dynamic circle at the object's position.
+
+            Args:
+                component: Component receiving the body.
+
+            Returns:
+                None
+            """
+            physics = component.physics
+            body = physics.world.CreateDynamicBody(position=(self.x * physics.pixels_to_meters,
+                                                             self.y * physics.pixels_to_meters))
+            body.CreateFixture(shape=b2CircleShape(radius=physics.convert_length_to_meters(8.0)), density=1.0)
+            component.body = body
+
+        self.body = self.add_component(BodyComponent(build=build_body))
+        self.scene.get_service(SnapshotService).register_fields(self, ["health", "cooldown", "is_active"])
+
+
+class SnapshotScene(Scene):
+    """Grid of dynamic bodies used to time SnapshotService."""
+    def __init__(self, body_count: int) -> None:
+        """Create the scene.
+
+        Args:
+            body_count: Dynamic bodies to create.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.body_count = body_count
+        self.snapshots: SnapshotService = None  # type: ignore[assignment]
+
+    def init_services(self) -> None:
+        """Register physics and snapshots.
+
+        Returns:
+            None
+        """
+        self.add_service(PhysicsService)
+        self.snapshots = self.add_service(SnapshotService)
+
+    def init(self) -> None:
+        """Create the bodies on a grid.
+
+        Returns:
+            None
+        """
+        columns = 25
+        for index in range(self.body_count):
+            self.add_game_object(SnapshotBody(40.0 + (index % columns) * 24.0, 40.0 + (index // columns) * 24.0))
+
+
+def run_snapshots(game: Game, body_count: int, iterations: int, delta_time: float) -> Dict[str, Any]:
+    """Time SnapshotService capture and restore.
+
+    Args:
+        game: Initialized game with a hidden window.
+        body_count: Dynamic bodies in the snapshot.
+        iterations: Captures and restores to time.
+        delta_time: Fixed time step of the frames run before timing.
+
+    Returns:
+        Mean capture and restore time in milliseconds, and the snapshot size.
+    """
+    game.current_scene = game.add_scene("snapshot", SnapshotScene, body_count)
+    for _ in range(10):
+        game.update(delta_time)
+    snapshots = game.current_scene.get_service(SnapshotService)
+    buffer = snapshots.allocate()
+    start = time.perf_counter()
+    for _ in range(iterations):
+        snapshots.capture(buffer)
+    capture_ms = (time.perf_counter() - start) * 1000.0 / iterations
+    start = time.perf_counter()
+    for _ in range(iterations):
+        snapshots.restore(buffer)
+    restore_ms = (time.perf_counter() - start) * 1000.0 / iterations
+    return {"bodies": body_count, "values": snapshots.size, "capture_ms": capture_ms, "restore_ms": restore_ms}
+
+
+def is_compiled() -> bool:
+    """Check whether the engine core was imported from a compiled extension.
+
+    Returns:
+        True if engine.framework is an extension module.
+    """
+    return not engine.framework.__file__.endswith(".py")
+
+
+def average_render_stats(frames: List[Dict[str, Any]]) -> Dict[str, Any]:
+    """Average per-frame render counts.
+
+    Args:
+        frames: render.stats.last of every timed frame.
+
+    Returns:
+        Same layout as render.stats.last, with counts averaged over all frames.
+    """
+    count = max(1, len(frames))
+    totals: Dict[str, float] = {name: 0.0 for name in render.COUNTERS}
+    groups: Dict[str, Dict[str, Dict[str, float]]] = {"cameras": {}, "owners": {}}
+    for frame in frames:
+        for name, value in frame["totals"].items():
+            totals[name] += value / count
+        for group, entries in groups.items():
+            for label, counts in frame[group].items():
+                entry = entries.setdefault(label, {name: 0.0 for name in render.COUNTERS})
+                for name, value in counts.items():
+                    entry[name] += value / count
+    return {"totals": totals, **groups}
+
+
+def run_scene(game: Game, name: str, frames: int, warmup: int, delta_time: float) -> Dict[str, Any]:
+    """Run one scene and time its frames.
+
+    Args:
+        game: Initialized game with a hidden window.
+        name: Scene to run.
+        frames: Frames to time.
+        warmup: Frames to run first without timing.
+        delta_time: Fixed time step passed to every frame.
+
+    Returns:
+        Frame time statistics in milliseconds, and average render counts.
+    """
+    game.current_scene = game.add_scene(name, SCENES[name])
+    gc_manager = game.get_manager(GcManager)
+    for _ in range(warmup):
+        game.update(delta_time)
+    samples: List[float] = []
+    render_frames: List[Dict[str, Any]] = []
+    for _ in range(frames):
+        start = time.perf_counter()
+        game.update(delta_time)
+        samples.append((time.perf_counter() - start) * 1000.0)
+        if render.stats.enabled:
+            render_frames.append(render.stats.last)
+    samples.sort()
+    gc_frames = list(gc_manager.history)[-frames:]
+    stats: Dict[str, Any] = {
+        "gc_ms_per_frame": statistics.fmean(f.gc_ms for f in gc_frames) if gc_frames else 0.0,
+        "max_gc_ms": max((f.gc_ms for f in gc_frames), default=0.0),
+        "mean_ms": statistics.fmean(samples),
+        "median_ms": samples[len(samples) // 2],
+        "p99_ms": samples[min(len(samples) - 1, int(len(samples) * 0.99))],
+        "max_ms": samples[-1],
+    }
+    if render_frames:
+        stats["render"] = average_render_stats(render_frames)
+    return stats
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Headless frame-time benchmark of the sample scenes.")
+    parser.add_argument("--frames", type=int, default=600, help="Frames to time per scene.")
+    parser.add_argument("--warmup", type=int, default=60, help="Untimed frames per scene.")
+    parser.add_argument("--scenes", nargs="*", default=list(SCENES), choices=list(SCENES))
+    parser.add_argument("--json", help="Write results to this file.")
+    parser.add_argument("--no-render-stats", action="store_true",
+                        help="Don't count draw calls (removes the counting overhead from frame times).")
+    parser.add_argument("--snapshot-bodies", type=int, default=500,
+                        help="Dynamic bodies in the snapshot benchmark (0 to skip it).")
+    args = parser.parse_args()
+
+    rl.set_config_flags(rl.FLAG_WINDOW_HIDDEN)
+    rl.set_trace_log_level(rl.LOG_WARNING)
+    game = Game()
+    game.add_manager(WindowManager, 1280, 720, "Benchmark")
+    font_manager = game.add_manager(FontManager)
+    game.add_manager(InputManager)
+    game.add_manager(GcManager)
+    game.init()
+    rl.set_target_fps(0)
+    render.stats.enabled = not args.no_render_stats
+    font_manager.load_font("Roboto", "assets/fonts/Roboto.ttf", 64)
+    font_manager.load_font("Tiny5", "assets/fonts/Tiny5.ttf", 64)
+
+    results = {"compiled": is_compiled(), "frames": args.frames, "scenes": {}}
+    for name in args.scenes:
+        results["scenes"][name] = run_scene(game, name, args.frames, args.warmup, 1.0 / 60.0)
+        stats = results["scenes"][name]
+        draw_calls = f"draw calls {stats['render']['totals']['draw_calls']:6.1f}  " if "render" in stats else ""
+        print(f"{name:<12} mean {stats['mean_ms']:7.3f} ms  median {stats['median_ms']:7.3f} ms  "
+              f"p99 {stats['p99_ms']:7.3f} ms  {draw_calls}({'compiled' if results['compiled'] else 'interpreted'})")
+    if args.snapshot_bodies > 0:
+        results["snapshot"] = run_snapshots(game, args.snapshot_bodies, 200, 1.0 / 60.0)
+        stats = results["snapshot"]
+        print(f"{'snapshot':<12} capture {stats['capture_ms']:7.3f} ms  restore {stats['restore_ms']:7.3f} ms  "
+              f"({stats['bodies']} bodies, {stats['values']} values)")
+    rl.close_window()
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as handle:
+            json.dump(results, handle, indent=2)
+
+
+if __name__ == "__main__":
+    main()
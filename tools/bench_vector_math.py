@@ -0,0 +1,112 @@
+"""Micro-benchmarks for engine/math_extensions: cffi rl.Vector2 helpers vs Vec2.
+
+Run from the repository root:
+
+    python -m tools.bench_vector_math [--number N] [--json]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import timeit
+from typing import Callable, Dict, List, Tuple
+
+from engine.math_extensions import Vec2, v2, vec_add, vec_len, vec_mul, vec_normalize, vec_sub
+from engine.prefabs.components import TopDownMovementComponent
+
+
+def _cases() -> List[Tuple[str, Callable[[], object], Callable[[], object]]]:
+    """Build (name, rl.Vector2 version, Vec2 version) pairs doing the same work.
+
+    Returns:
+        List of benchmark cases.
+    """
+    ra, rb = v2(3.0, 4.0), v2(1.0, -2.0)
+    va, vb = Vec2(3.0, 4.0), Vec2(1.0, -2.0)
+    scratch = Vec2()
+
+    def rl_create():
+        return v2(1.0, 2.0)
+
+    def vec_create():
+        return Vec2(1.0, 2.0)
+
+    def rl_read():
+        return ra.x + ra.y + rb.x + rb.y
+
+    def vec_read():
+        return va.x + va.y + vb.x + vb.y
+
+    def rl_expression():
+        return vec_add(ra, vec_mul(vec_sub(rb, ra), 0.5))
+
+    def vec_expression():
+        return va + (vb - va) * 0.5
+
+    def vec_expression_ip():
+        return scratch.set_from(vb).__isub__(va).__imul__(0.5).__iadd__(va)
+
+    def rl_normalize():
+        return vec_len(vec_normalize(ra))
+
+    def vec_normalize_ip():
+        return scratch.set_from(va).normalize_ip().length()
+
+    def rl_move_towards():
+        return TopDownMovementComponent.move_towards_vec(ra, rb, 0.25)
+
+    def vec_move_towards():
+        return scratch.set_from(va).move_towards_ip(vb.x, vb.y, 0.25)
+
+    def rl_friction():
+        return TopDownMovementComponent.apply_friction(ra, 0.25)
+
+    def vec_friction():
+        return scratch.set_from(va).shrink_ip(0.25)
+
+    return [
+        ("create", rl_create, vec_create),
+        ("read 4 fields", rl_read, vec_read),
+        ("a + (b - a) * 0.5", rl_expression, vec_expression),
+        ("a + (b - a) * 0.5 in place", rl_expression, vec_expression_ip),
+        ("normalize + length", rl_normalize, vec_normalize_ip),
+        ("move towards", rl_move_towards, vec_move_towards),
+        ("friction", rl_friction, vec_friction),
+    ]
+
+
+def run(number: int) -> List[Dict[str, float]]:
+    """Time every case.
+
+    Args:
+        number: Calls per measurement; the best of 5 measurements is kept.
+
+    Returns:
+        One result dict per case, with nanoseconds per call.
+    """
+    results = []
+    for name, rl_case, vec_case in _cases():
+        rl_ns = min(timeit.repeat(rl_case, number=number, repeat=5)) / number * 1e9
+        vec_ns = min(timeit.repeat(vec_case, number=number, repeat=5)) / number * 1e9
+        results.append({"case": name, "rl_vector2_ns": rl_ns, "vec2_ns": vec_ns, "speedup": rl_ns / vec_ns})
+    return results
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--number", type=int, default=200000, help="Calls per measurement.")
+    parser.add_argument("--json", action="store_true", help="Print results as JSON.")
+    args = parser.parse_args()
+
+    results = run(args.number)
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+    print(f"{'case':<30}{'rl.Vector2 ns':>15}{'Vec2 ns':>12}{'speedup':>10}")
+    for result in results:
+        print(f"{result['case']:<30}{result['rl_vector2_ns']:>15.1f}{result['vec2_ns']:>12.1f}{result['speedup']:>9.2f}x")
+
+
+if __name__ == "__main__":
+    main()
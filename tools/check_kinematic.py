@@ -0,0 +1,196 @@
+"""Headless check of the kinematic platformer controller on the collecting level.
+
+Places a PlatformerCharacter with CharacterParams.kinematic at the level's
+first start point and drives it with scripted input (settle, run right, jump,
+run left and jump again). Checks that it lands, walks, leaves the ground and
+lands again, and never ends a frame inside a solid cell. The same script is
+run with the dynamic controller for comparison:
+
+    python -m tools.check_kinematic [--frames N]
+
+Exits with status 1 if a check fails.
+"""
+
+from __future__ import annotations
+
+import argparse
+from typing import Any, Dict, List
+
+from engine.framework import Game, Scene
+from engine.prefabs.game_objects import CharacterParams, PlatformerCharacter
+from engine.prefabs.managers import InputManager, WindowManager
+from engine.prefabs.services import LevelService, PhysicsService, TextureService, TimerService
+
+FIXED_DELTA_TIME = 1.0 / 60.0
+# (first frame, move_x, jump held) for each phase of the script.
+SCRIPT = ((0, 0.0, False), (60, 1.0, False), (180, 1.0, True), (200, -1.0, False), (240, -1.0, True),
+          (260, -1.0, False), (300, 0.0, False))
+
+
+class ScriptedInput:
+    """Input source playing SCRIPT on player 0."""
+    def __init__(self, input_manager: InputManager) -> None:
+        """Create the source.
+
+        Args:
+            input_manager: Manager whose action layout the script fills.
+
+        Returns:
+            None
+        """
+        self.frame = 0
+        self.frames = [[0.0] * len(input_manager.action_names) for _ in range(input_manager.player_count)]
+
+    def __call__(self) -> List[List[float]]:
+        """Produce the next frame of input.
+
+        Returns:
+            Action values per player.
+        """
+        _, move_x, jump = [phase for phase in SCRIPT if phase[0] <= self.frame][-1]
+        values = self.frames[0]
+        values[InputManager.MOVE_X] = move_x
+        values[InputManager.JUMP] = 1.0 if jump else 0.0
+        self.frame += 1
+        return self.frames
+
+
+class KinematicCheckScene(Scene):
+    """Collecting level with one platformer character."""
+    def __init__(self, kinematic: bool) -> None:
+        """Create the scene.
+
+        Args:
+            kinematic: True for the kinematic controller, False for the dynamic one.
+
+        Returns:
+            None
+        """
+        super().__init__()
+        self.kinematic = kinematic
+        self.level: LevelService = None  # type: ignore[assignment]
+        self.character: PlatformerCharacter = None  # type: ignore[assignment]
+
+    def init_services(self) -> None:
+        """Register the services PlatformerCharacter and LevelService need.
+
+        Returns:
+            None
+        """
+        self.add_service(TextureService)
+        self.add_service(TimerService)
+        self.add_service(PhysicsService)
+        self.level = self.add_service(LevelService, "assets/levels/collecting.ldtk", "Level",
+                                      ["walls", "clouds", "trees"])
+
+    def init(self) -> None:
+        """Place the character at the first start point.
+
+        Returns:
+            None
+        """
+        params = CharacterParams()
+        params.position = self.level.convert_to_pixels(self.level.get_entities_by_name("Start")[0].getPosition())
+        params.width = 16
+        params.height = 24
+        params.kinematic = self.kinematic
+        self.character = self.add_game_object(PlatformerCharacter(params))
+
+
+def simulate(kinematic: bool, frames: int) -> Dict[str, Any]:
+    """Run the script headless and record the character every frame.
+
+    Args:
+        kinematic: Controller to use.
+        frames: Frames to simulate.
+
+    Returns:
+        {"x", "y", "grounded", "inside_solid"} lists, one entry per frame.
+    """
+    game = Game()
+    game.headless = True
+    game.fixed_delta_time = FIXED_DELTA_TIME
+    game.add_manager(WindowManager, 1280, 720, "Kinematic check")
+    input_manager = game.add_manager(InputManager)
+    game.init()
+    input_manager.source = ScriptedInput(input_manager)
+    scene = game.add_scene("check", KinematicCheckScene, kinematic)
+
+    record: Dict[str, List[Any]] = {"x": [], "y": [], "grounded": [], "inside_solid": []}
+    grid = None
+    for _ in range(frames):
+        # The first update initializes the scene and loads the level.
+        game.update(FIXED_DELTA_TIME)
+        if grid is None:
+            grid = scene.level.get_collision_grid()
+        solid, cell_size = grid
+        position = scene.character.body.get_position_pixels()
+        row, column = int(position.y // cell_size), int(position.x // cell_size)
+        inside = 0 <= row < solid.shape[0] and 0 <= column < solid.shape[1] and bool(solid[row, column])
+        record["x"].append(position.x)
+        record["y"].append(position.y)
+        record["grounded"].append(scene.character.movement.grounded)
+        record["inside_solid"].append(inside)
+    game.shutdown()
+    return record
+
+
+def check(record: Dict[str, Any]) -> List[str]:
+    """Check a kinematic run against the script.
+
+    Args:
+        record: Result of simulate.
+
+    Returns:
+        Descriptions of the failed checks.
+    """
+    failures = []
+    x, y, grounded = record["x"], record["y"], record["grounded"]
+    if not grounded[59]:
+        failures.append("not grounded after settling for 60 frames")
+    if max(abs(value - x[59]) for value in x[60:180]) < 20.0:
+        failures.append("moved less than 20 px while running right")
+    if min(y[180:240]) > y[179] - 10.0:
+        failures.append("rose less than 10 px after jumping")
+    if not any(grounded[200:300]):
+        failures.append("did not land after the first jump")
+    if any(record["inside_solid"]):
+        failures.append(f"inside a solid cell at frame {record['inside_solid'].index(True)}")
+    return failures
+
+
+def summary(record: Dict[str, Any]) -> str:
+    """Describe a run in one line.
+
+    Args:
+        record: Result of simulate.
+
+    Returns:
+        Distance travelled, jump height, and grounded frames.
+    """
+    x, y = record["x"], record["y"]
+    distance = sum(abs(b - a) for a, b in zip(x, x[1:]))
+    return (f"travelled {distance:7.1f} px  jump {y[179] - min(y[180:240]):6.1f} px  "
+            f"grounded {sum(record['grounded']):4d}/{len(x)} frames")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Check the kinematic platformer controller headless.")
+    parser.add_argument("--frames", type=int, default=360, help="Frames to simulate (at least 300).")
+    args = parser.parse_args()
+    frames = max(300, args.frames)
+
+    kinematic = simulate(True, frames)
+    dynamic = simulate(False, frames)
+    print(f"{'kinematic':<10} {summary(kinematic)}")
+    print(f"{'dynamic':<10} {summary(dynamic)}")
+    failures = check(kinematic)
+    for failure in failures:
+        print(f"Kinematic controller {failure}")
+    if not failures:
+        print("Kinematic controller passed")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,130 @@
+"""Check that a recorded input log simulates identically run after run.
+
+Replays the log headless in two separate processes (with different Python
+hash seeds, so set and dict ordering differences show up too), records a
+per-frame checksum of every registered body transform, and reports the first
+frame where the runs diverge:
+
+    python -m tools.verify_determinism session.log [--runs N]
+
+Exits with status 1 if any run diverges.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List
+
+import pyray as rl
+
+from engine.framework import Game
+from engine.prefabs.managers import FontManager, InputManager, WindowManager
+from engine.prefabs.services import PhysicsService
+from samples.collecting_game import CollectingScene
+from samples.fighting_game import FightingScene
+from samples.title_screen import TitleScreen
+from samples.zombie_game import ZombieScene
+
+FIXED_DELTA_TIME = 1.0 / 60.0
+
+
+def record_checksums(log: str) -> Dict[str, List]:
+    """Replay a log headless and checksum every frame.
+
+    Scenes are registered in the same order as main.py, so scene changes
+    recorded in the log happen at the same frames.
+
+    Args:
+        log: Input log path.
+
+    Returns:
+        {"scenes": scene name per frame, "checksums": checksum per frame}.
+    """
+    rl.set_config_flags(rl.FLAG_WINDOW_HIDDEN)
+    rl.set_trace_log_level(rl.LOG_WARNING)
+    game = Game()
+    game.add_manager(WindowManager, 1280, 720, "Determinism check")
+    font_manager = game.add_manager(FontManager)
+    input_manager = game.add_manager(InputManager)
+    game.init()
+    rl.set_target_fps(0)
+    font_manager.load_font("Roboto", "assets/fonts/Roboto.ttf", 64)
+    font_manager.load_font("Tiny5", "assets/fonts/Tiny5.ttf", 64)
+
+    game.add_scene("title", TitleScreen)
+    game.add_scene("fighting", FightingScene)
+    game.add_scene("collecting", CollectingScene)
+    game.add_scene("zombie", ZombieScene)
+    names = {id(scene): name for name, scene in game.scenes.items()}
+
+    game.seed = input_manager.start_replay(log)
+    rl.set_random_seed(game.seed)
+    game.fixed_delta_time = FIXED_DELTA_TIME
+    game.draw_enabled = False
+
+    scenes: List[str] = []
+    checksums: List[int] = []
+    while not input_manager.is_replay_finished():
+        game.update(input_manager.next_delta_time(FIXED_DELTA_TIME))
+        scene = game.current_scene
+        scenes.append(names.get(id(scene), ""))
+        checksums.append(scene.get_service(PhysicsService).checksum() if scene.has_service(PhysicsService) else 0)
+    input_manager.stop()
+    rl.close_window()
+    return {"scenes": scenes, "checksums": checksums}
+
+
+def run_child(log: str, hash_seed: int) -> Dict[str, List]:
+    """Replay the log in a fresh interpreter.
+
+    Args:
+        log: Input log path.
+        hash_seed: PYTHONHASHSEED for the child process.
+
+    Returns:
+        The child's record_checksums result.
+    """
+    with tempfile.TemporaryDirectory() as directory:
+        output = os.path.join(directory, "checksums.json")
+        env = dict(os.environ, PYTHONHASHSEED=str(hash_seed))
+        subprocess.run([sys.executable, "-m", "tools.verify_determinism", log, "--child", output],
+                       check=True, env=env)
+        with open(output, "r", encoding="utf-8") as handle:
+            return json.load(handle)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Check that an input log replays deterministically.")
+    parser.add_argument("log", help="Input log written with main.py --record.")
+    parser.add_argument("--runs", type=int, default=2, help="Number of replays to compare.")
+    parser.add_argument("--child", metavar="OUT", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        with open(args.child, "w", encoding="utf-8") as handle:
+            json.dump(record_checksums(args.log), handle)
+        return 0
+
+    reference = run_child(args.log, 1)
+    frames = len(reference["checksums"])
+    for run in range(1, args.runs):
+        result = run_child(args.log, run + 1)
+        for frame, (expected, actual) in enumerate(zip(reference["checksums"], result["checksums"])):
+            if expected != actual:
+                print(f"Run {run + 1} diverges at frame {frame} in scene '{result['scenes'][frame]}': "
+                      f"checksum {actual:08x}, expected {expected:08x}")
+                return 1
+        if len(result["checksums"]) != frames:
+            print(f"Run {run + 1} simulated {len(result['checksums'])} frames, expected {frames}")
+            return 1
+    print(f"{args.runs} runs of {frames} frames match")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())